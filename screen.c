@@ -0,0 +1,385 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "screen.h"
+#include <stdlib.h>
+#include <string.h>
+
+// States of the escape sequence parser
+#define screen_ground 0
+#define screen_escape 1                 // after ESC
+#define screen_csi 2                    // after ESC [
+
+static Screen* screen_construct(unsigned char rows, unsigned char columns) {
+    unsigned short cells = rows * columns;
+    Screen* screen = calloc(1, sizeof(Screen));
+    if (screen == NULL)
+        return NULL;
+    screen->chars = malloc(cells);
+    screen->attributes = calloc(1, cells);
+    screen->changed = calloc(1, (cells + 7) / 8);
+    if (screen->chars == NULL || screen->attributes == NULL ||
+            screen->changed == NULL) {
+        free(screen->chars);
+        free(screen->attributes);
+        free(screen->changed);
+        free(screen);
+        return NULL;
+    }
+    memset(screen->chars, ' ', cells);
+    screen->rows = rows;
+    screen->columns = columns;
+    screen->changed_from = cells;
+    return screen;
+}
+
+static void screen_free(Screen* screen) {
+    free(screen->chars);
+    free(screen->attributes);
+    free(screen->changed);
+    free(screen);
+}
+
+static unsigned screen_changed(Screen* screen, unsigned short cell) {
+    return (screen->changed[cell >> 3] >> (cell & 7)) & 1;
+}
+
+/**
+ * Set a cell, and remember it changed if it did
+ */
+static void screen_set(Screen* screen, unsigned short cell, char c,
+        unsigned char attribute) {
+    if (screen->chars[cell] == c && screen->attributes[cell] == attribute)
+        return;
+    screen->chars[cell] = c;
+    screen->attributes[cell] = attribute;
+    screen->changed[cell >> 3] |= 1 << (cell & 7);
+    if (cell < screen->changed_from)
+        screen->changed_from = cell;
+    if (cell >= screen->changed_to)
+        screen->changed_to = cell + 1;
+}
+
+/**
+ * Blank the cells from one up to another
+ */
+static void screen_erase(Screen* screen, unsigned short from,
+        unsigned short to) {
+    for (; from < to; from++)
+        screen_set(screen, from, ' ', 0);
+}
+
+/**
+ * Move the rows from top to bottom up (n > 0) or down (n < 0) by one, and
+ * blank the row that comes free
+ */
+static void screen_scroll(Screen* screen, int n) {
+    unsigned short cells = screen->rows * screen->columns;
+    unsigned short columns = screen->columns;
+    unsigned short cell;
+    if (n > 0) {
+        for (cell = 0; cell + columns < cells; cell++)
+            screen_set(screen, cell, screen->chars[cell + columns],
+                    screen->attributes[cell + columns]);
+        screen_erase(screen, cells - columns, cells);
+    } else {
+        for (cell = cells - 1; cell >= columns; cell--)
+            screen_set(screen, cell, screen->chars[cell - columns],
+                    screen->attributes[cell - columns]);
+        screen_erase(screen, 0, columns);
+    }
+}
+
+/**
+ * Move the cursor. Positions outside of the screen are clipped.
+ */
+static void screen_move(Screen* screen, int row, int column) {
+    if (row < 0)
+        row = 0;
+    else if (row >= screen->rows)
+        row = screen->rows - 1;
+    if (column < 0)
+        column = 0;
+    else if (column >= screen->columns)
+        column = screen->columns - 1;
+    if (row != screen->row || column != screen->column)
+        screen->cursor_moved = 1;
+    screen->row = row;
+    screen->column = column;
+    screen->wrap = 0;
+}
+
+/**
+ * Move the cursor down a row, and scroll when it is on the last row
+ */
+static void screen_line_feed(Screen* screen) {
+    if (screen->row + 1 == screen->rows)
+        screen_scroll(screen, 1);
+    else
+        screen_move(screen, screen->row + 1, screen->column);
+    screen->wrap = 0;
+}
+
+static void screen_reset(Screen* screen) {
+    screen_erase(screen, 0, screen->rows * screen->columns);
+    screen_move(screen, 0, 0);
+    screen->attribute = 0;
+    screen->saved_row = screen->saved_column = screen->saved_attribute = 0;
+}
+
+/**
+ * The nth parameter of an escape sequence, or def if it was not given or 0
+ */
+static unsigned char screen_param(Screen* screen, unsigned char n,
+        unsigned char def) {
+    if (n >= screen->n_params || !screen->params[n])
+        return def;
+    return screen->params[n];
+}
+
+static void screen_sgr(Screen* screen) {
+    unsigned char i;
+    if (!screen->n_params)
+        screen->attribute = 0;
+    for (i = 0; i < screen->n_params; i++) {
+        switch (screen->params[i]) {
+            case 0: screen->attribute = 0; break;
+            case 1: screen->attribute |= screen_bold; break;
+            case 4: screen->attribute |= screen_underline; break;
+            case 5: screen->attribute |= screen_blink; break;
+            case 7: screen->attribute |= screen_reverse; break;
+            case 8: screen->attribute |= screen_hidden; break;
+            case 22: screen->attribute &= ~screen_bold; break;
+            case 24: screen->attribute &= ~screen_underline; break;
+            case 25: screen->attribute &= ~screen_blink; break;
+            case 27: screen->attribute &= ~screen_reverse; break;
+            case 28: screen->attribute &= ~screen_hidden; break;
+        }
+    }
+}
+
+/**
+ * Execute a control sequence (CSI) with its final byte
+ */
+static void screen_csi_dispatch(Screen* screen, char final) {
+    unsigned short columns = screen->columns;
+    unsigned short cursor = screen->row * columns + screen->column;
+    unsigned short cells = screen->rows * columns;
+    unsigned char n = screen_param(screen, 0, 1);
+    
+    if (screen->private_sequence)
+        return;
+    switch (final) {
+        case 'A': screen_move(screen, screen->row - n, screen->column); break;
+        case 'B':
+        case 'e': screen_move(screen, screen->row + n, screen->column); break;
+        case 'C':
+        case 'a': screen_move(screen, screen->row, screen->column + n); break;
+        case 'D': screen_move(screen, screen->row, screen->column - n); break;
+        case 'E': screen_move(screen, screen->row + n, 0); break;
+        case 'F': screen_move(screen, screen->row - n, 0); break;
+        case 'G':
+        case '`': screen_move(screen, screen->row, n - 1); break;
+        case 'd': screen_move(screen, n - 1, screen->column); break;
+        case 'H':
+        case 'f':
+            screen_move(screen, n - 1, screen_param(screen, 1, 1) - 1);
+            break;
+        case 'J':
+            n = screen_param(screen, 0, 0);
+            if (n == 0)
+                screen_erase(screen, cursor, cells);
+            else if (n == 1)
+                screen_erase(screen, 0, cursor + 1);
+            else
+                screen_erase(screen, 0, cells);
+            break;
+        case 'K':
+            n = screen_param(screen, 0, 0);
+            if (n == 0)
+                screen_erase(screen, cursor, cursor - screen->column + columns);
+            else if (n == 1)
+                screen_erase(screen, cursor - screen->column, cursor + 1);
+            else
+                screen_erase(screen, cursor - screen->column,
+                        cursor - screen->column + columns);
+            break;
+        case 'X':
+            if (n > columns - screen->column)
+                n = columns - screen->column;
+            screen_erase(screen, cursor, cursor + n);
+            break;
+        case 'm':
+            screen_sgr(screen);
+            break;
+        case 's':
+            screen->saved_row = screen->row;
+            screen->saved_column = screen->column;
+            break;
+        case 'u':
+            screen_move(screen, screen->saved_row, screen->saved_column);
+            break;
+    }
+}
+
+/**
+ * Execute an escape sequence that is not a control sequence
+ */
+static void screen_escape_dispatch(Screen* screen, char c) {
+    switch (c) {
+        case '7':
+            screen->saved_row = screen->row;
+            screen->saved_column = screen->column;
+            screen->saved_attribute = screen->attribute;
+            break;
+        case '8':
+            screen_move(screen, screen->saved_row, screen->saved_column);
+            screen->attribute = screen->saved_attribute;
+            break;
+        case 'E':
+            screen_move(screen, screen->row, 0);
+            // fall through
+        case 'D':
+            screen_line_feed(screen);
+            break;
+        case 'M':
+            if (screen->row == 0)
+                screen_scroll(screen, -1);
+            else
+                screen_move(screen, screen->row - 1, screen->column);
+            break;
+        case 'c':
+            screen_reset(screen);
+            break;
+    }
+}
+
+/**
+ * Write a printable character at the cursor, and move the cursor on
+ */
+static void screen_print_char(Screen* screen, char c) {
+    if (screen->wrap) {
+        screen_move(screen, screen->row, 0);
+        screen_line_feed(screen);
+    }
+    screen_set(screen, screen->row * screen->columns + screen->column, c,
+            screen->attribute);
+    if (screen->column + 1 < screen->columns) {
+        screen->column++;
+        screen->cursor_moved = 1;
+    } else {
+        screen->wrap = 1;               // wrap when the next character comes
+    }
+}
+
+/**
+ * Feed one byte to the escape sequence parser
+ */
+static void screen_byte(Screen* screen, char c) {
+    if (c == 0x1b) {
+        screen->state = screen_escape;
+        return;
+    }
+    if (screen->state == screen_escape) {
+        if (c == '[') {
+            screen->state = screen_csi;
+            screen->n_params = 0;
+            screen->private_sequence = 0;
+            memset(screen->params, 0, sizeof(screen->params));
+        } else {
+            screen->state = screen_ground;
+            screen_escape_dispatch(screen, c);
+        }
+        return;
+    }
+    if (screen->state == screen_csi) {
+        if (c >= '0' && c <= '9') {
+            if (!screen->n_params)
+                screen->n_params = 1;
+            if (screen->n_params <= screen_max_params) {
+                unsigned short p = screen->params[screen->n_params - 1] * 10 +
+                        (c - '0');
+                screen->params[screen->n_params - 1] = p > 255 ? 255 : p;
+            }
+        } else if (c == ';') {
+            if (!screen->n_params)
+                screen->n_params = 1;
+            if (screen->n_params <= screen_max_params)
+                screen->n_params++;
+        } else if (c == '?') {
+            screen->private_sequence = 1;
+        } else if (c >= 0x40 && c <= 0x7e) {
+            if (screen->n_params > screen_max_params)
+                screen->n_params = screen_max_params;
+            screen->state = screen_ground;
+            screen_csi_dispatch(screen, c);
+        } else if (c < 0x20 || c > 0x3f) {
+            screen->state = screen_ground; // not a valid sequence
+        }
+        return;
+    }
+    
+    switch (c) {
+        case '\r':
+            screen_move(screen, screen->row, 0);
+            break;
+        case '\n':
+            screen_move(screen, screen->row, 0);
+            screen_line_feed(screen);
+            break;
+        case '\b':
+            screen_move(screen, screen->row, screen->column - 1);
+            break;
+        case '\t':
+            screen_move(screen, screen->row, (screen->column + 8) & ~7);
+            break;
+        default:
+            if ((unsigned char) c >= 0x20 && c != 0x7f)
+                screen_print_char(screen, c);
+    }
+}
+
+static void screen_write(Screen* screen, const char* data, unsigned int n) {
+    unsigned int i;
+    unsigned short cells = screen->rows * screen->columns;
+    for (i = 0; i < n; i++)
+        screen_byte(screen, data[i]);
+    if (screen->changed_from >= screen->changed_to && !screen->cursor_moved)
+        return;
+    if (screen->update)
+        screen->update(screen);
+    if (screen->changed_from < screen->changed_to)
+        memset(screen->changed + (screen->changed_from >> 3), 0, 
+                ((screen->changed_to + 7) >> 3) - (screen->changed_from >> 3));
+    screen->changed_from = cells;
+    screen->changed_to = 0;
+    screen->cursor_moved = 0;
+}
+
+static void screen_print(Screen* screen, const char* string) {
+    screen_write(screen, string, strlen(string));
+}
+
+const Screen_namespace screen = {
+    screen_construct,
+    screen_free,
+    screen_write,
+    screen_print,
+    screen_changed
+};
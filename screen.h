@@ -0,0 +1,129 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ * 
+ * File:   screen.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * A Screen is a grid of character cells, written to as a VT100 terminal. Data
+ * that is written to it may contain escape sequences, which are interpreted
+ * as they come in, also when a sequence is split over several writes:
+ * 
+ *  - \r, \n (which also returns to the first column), \b and \t
+ *  - ESC 7 and ESC 8: save and restore the cursor and attributes
+ *  - ESC D, ESC E and ESC M: index, next line and reverse index
+ *  - ESC c: reset
+ *  - CSI A, B, C, D, E, F, G, d, H and f: cursor movement and positioning
+ *  - CSI J and CSI K: erase (part of) the screen or line
+ *  - CSI X: erase characters
+ *  - CSI m: select graphic rendition (bold, underline, blink, reverse and
+ *    hidden)
+ *  - CSI s and CSI u: save and restore the cursor
+ * 
+ * Other sequences are ignored. Writing at the end of a line wraps to the next,
+ * and moving below the last row scrolls the screen up.
+ * 
+ * The Screen remembers which cells changed since the last update: only the
+ * cells of which the character or attributes actually changed. After a
+ * write, the update callback is called when something changed, and can read
+ * this with changed. Afterwards, the changes are forgotten.
+ * 
+ * Like the Terminal, the functions are in a namespace struct:
+ * 
+ *     screen.write(...);
+ */
+
+#ifndef SCREEN_H
+#define	SCREEN_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+// Attributes, set with SGR (CSI m)
+#define screen_bold 0x01
+#define screen_underline 0x02
+#define screen_blink 0x04
+#define screen_reverse 0x08
+#define screen_hidden 0x10
+
+#ifndef screen_max_params
+#define screen_max_params 8             // parameters in an escape sequence
+#endif
+
+typedef struct Screen {
+    unsigned char rows, columns;      // size of the grid
+    char* chars;                      // the character of every cell
+    unsigned char* attributes;        // the screen_* attributes of every cell
+    unsigned char* changed;           // a bit per cell: whether it changed
+    unsigned short changed_from;      // first cell that may have changed
+    unsigned short changed_to;        // cell after the last that may have
+    unsigned cursor_moved;            // whether the cursor moved
+    void (*update)(struct Screen*);   // update callback
+    void* data;                       // for the update callback
+    
+    unsigned char row, column;        // cursor
+    unsigned wrap;                    // whether the next character wraps
+    unsigned char attribute;          // attributes of written characters
+    unsigned char saved_row, saved_column, saved_attribute;
+    
+    unsigned char state;              // state of the escape sequence parser
+    unsigned char params[screen_max_params]; // parameters of the sequence
+    unsigned char n_params;           // number of parameters
+    unsigned private_sequence;        // whether the sequence started with ?
+} Screen;
+
+typedef struct {
+    /**
+     * Construct a new Screen of blank cells with the cursor at the top left
+     * @return NULL if allocating memory failed
+     */
+    Screen* (*const construct)(unsigned char rows, unsigned char columns);
+    
+    /**
+     * Free a Screen and all blocks allocated for it
+     */
+    void (*const free)(Screen*);
+    
+    /**
+     * Write n bytes of data to a Screen, and call the update callback if
+     * anything changed
+     */
+    void (*const write)(Screen*, const char* data, unsigned int n);
+    
+    /**
+     * Write a null-terminated string to a Screen
+     */
+    void (*const print)(Screen*, const char* string);
+    
+    /**
+     * Whether a cell changed since the last update. Cells are numbered row by
+     * row. Only the cells from changed_from up to changed_to can have
+     * changed.
+     */
+    unsigned (*const changed)(Screen*, unsigned short cell);
+} Screen_namespace;
+
+extern const Screen_namespace screen;
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCREEN_H */
@@ -18,166 +18,1209 @@
  */
 
 #include "t6963c.h"
+#include "t6963c_plan.h"
+#include <stddef.h>
+#include <string.h>
 
-inline void delay_ns(unsigned short ns) {
-    t6963c_startTimer();
-    while (t6963c_getTimeNs() < ns);
-    t6963c_stopTimer();
-}
+#define t6963c_cells(d) ((unsigned short) ((d)->rows * (d)->columns))
+#define t6963c_text_cells(d) ((unsigned short) ((d)->text_rows * (d)->columns))
+#define t6963c_cg_address(d, slot) \
+        ((((unsigned short) (d)->cg_offset) << 11) + 0x400 + (slot) * 8)
 
-void t6963c_writeByte(unsigned cd, char byte) {
+static void t6963c_pins_write(void* data, unsigned cd, unsigned char byte) {
+    (void) data;
     t6963c_cd(cd);
     t6963c_wr(0);
 	t6963c_data(byte);
+    t6963c_wait(t6963c_tas_ns);
     t6963c_ce(0);
-    delay_ns(200);
+    t6963c_wait(t6963c_tce_ns);
     t6963c_ce(1);
     t6963c_wr(1);
-    delay_ns(200);
+    t6963c_wait(t6963c_tdh_ns);
 }
 
-void t6963c_writeCmd1(char cmd, char data) {
-    t6963c_writeByte(0, data);
-    t6963c_writeByte(1, cmd);
-    delay_ns(60000);
+static unsigned char t6963c_pins_status(void* data) {
+    unsigned char status;
+    (void) data;
+    t6963c_t_data(0xff);
+    t6963c_cd(1);
+    t6963c_rd(0);
+    t6963c_wait(t6963c_tas_ns);
+    t6963c_ce(0);
+    t6963c_wait(t6963c_status_ns);
+    status = t6963c_data_in();
+    t6963c_ce(1);
+    t6963c_rd(1);
+    t6963c_wait(t6963c_tdh_ns);
+    t6963c_t_data(0x00);
+    return status;
 }
 
-void t6963c_writeCmd2(char cmd, char data1, char data2) {
-    t6963c_writeByte(0, data1);
-    t6963c_writeByte(0, data2);
-    t6963c_writeByte(1, cmd);
-    delay_ns(60000);
+static void t6963c_pins_reset(void* data) {
+    (void) data;
+    t6963c_t_rst(0);
+    t6963c_t_cd(0);
+    t6963c_t_ce(0);
+    t6963c_t_rd(0);
+    t6963c_t_wr(0);
+    t6963c_t_data(0x00);
+    
+    t6963c_wr(1);
+    t6963c_rd(1);
+    t6963c_cd(1);
+    t6963c_ce(1);
+    
+    t6963c_rst(0);
+    t6963c_wait(10 * t6963c_cmd_ns);
+    t6963c_rst(1);
 }
 
-void t6963c_startAutoWrite(void) {
-    t6963c_writeByte(1, 0xb0);
-    delay_ns(60000);
-    delay_ns(60000);
+const T6963C_Bus t6963c_pins = {
+    t6963c_pins_write, t6963c_pins_status, t6963c_pins_reset, NULL, NULL, NULL
+};
+
+#ifdef t6963c_stats
+#define t6963c_count(display, counter, n) ((display)->stats.counter += (n))
+#define t6963c_bytes(display) \
+        ((display)->stats.commands + (display)->stats.data)
+#else
+#define t6963c_count(display, counter, n)
+#endif
+
+static char t6963c_default_buffer[t6963c_display_buffer_size(
+        t6963c_rows, t6963c_columns, t6963c_text_rows)];
+
+T6963C_Display t6963c_default = {
+    .rows = t6963c_rows,
+    .columns = t6963c_columns,
+    .text_rows = t6963c_text_rows,
+    .graphic_home = t6963c_graphic_home,
+    .cg_offset = t6963c_cg_offset,
+    .bus = {
+        t6963c_pins_write, t6963c_pins_status, t6963c_pins_reset, NULL,
+        NULL, NULL
+    },
+    .shadow = t6963c_default_buffer,
+    .shadow_attr = t6963c_default_buffer + t6963c_text_rows * t6963c_columns,
+    .frame = t6963c_default_buffer + 2 * t6963c_text_rows * t6963c_columns,
+    .frame_attr = t6963c_default_buffer + 
+            (2 * t6963c_text_rows + t6963c_rows) * t6963c_columns
+};
+
+void t6963c_wait_ns(unsigned long ns) {
+    t6963c_wait_ticks(t6963c_ticks(ns));
 }
 
-void t6963c_stopAutoWrite(void) {
-    t6963c_writeByte(1, 0xb2);
-    delay_ns(60000);
-    delay_ns(60000);
+void t6963c_display_setup(T6963C_Display* display, const T6963C_Bus* bus,
+        unsigned char rows, unsigned char columns, unsigned short text_rows,
+        char* buffer) {
+    display->rows = rows;
+    display->columns = columns;
+    display->text_rows = text_rows;
+    display->graphic_home = (text_rows * columns + 0xff) & 0xff00;
+    display->cg_offset = (display->graphic_home + (text_rows + 
+            (t6963c_graphic_pages - 1) * rows) * columns * 8 + 0x3ff) >> 11;
+    display->bus = *bus;
+    display->shadow = buffer;
+    display->shadow_attr = buffer + text_rows * columns;
+    display->frame = buffer + 2 * text_rows * columns;
+    display->frame_attr = display->frame + rows * columns;
+    display->busy = 0;
+    display->auto_write = 0;
+    display->write_end = 0;
+    display->screen = NULL;
+    display->terminal = NULL;
+    display->glyphs = NULL;
+#ifdef t6963c_stats
+    t6963c_display_reset_stats(display);
+#endif
 }
 
-void t6963c_autoWrite(char byte) {
-    t6963c_cd(0);
-    t6963c_wr(0);
-    t6963c_data(byte);
-    t6963c_ce(0);
-    delay_ns(200);
-    t6963c_ce(1);
-    t6963c_wr(1);
-    delay_ns(6000);
+/**
+ * Remember that the LCD is busy with the last byte. With status checking, the
+ * status byte may tell that it is ready before ns ns have passed.
+ */
+static void t6963c_settle(T6963C_Display* display, unsigned char mask,
+        unsigned long ns) {
+    display->busy = 1;
+    display->ready_mask = mask;
+    display->ready_at = t6963c_timestamp() + t6963c_ticks(ns);
 }
 
-inline void t6963c_autoWriteChar(char byte) {
-    t6963c_autoWrite(byte - 0x20);
+unsigned t6963c_display_idle(T6963C_Display* display) {
+    if (!display->busy)
+        return 1;
+    if ((long) (t6963c_timestamp() - display->ready_at) < 0) {
+#ifdef t6963c_status_check
+        if (!display->bus.status || (display->bus.status(display->bus.data)
+                & display->ready_mask) != display->ready_mask)
+            return 0;
+#else
+        return 0;
+#endif
+    }
+    display->busy = 0;
+    return 1;
 }
 
-void t6963c_writeString(char* string) {
-    t6963c_startAutoWrite();
-    for (;*string;string++)
-        t6963c_autoWriteChar(*string);
-    t6963c_stopAutoWrite();
+void t6963c_display_wait(T6963C_Display* display) {
+#ifdef t6963c_stats
+    unsigned long start;
+    if (t6963c_display_idle(display))
+        return;
+    start = t6963c_timestamp();
+    while (!t6963c_display_idle(display));
+    display->stats.wait_ns += 
+            (unsigned long long) (t6963c_timestamp() - start) * t6963c_nspertick;
+#else
+    while (!t6963c_display_idle(display));
+#endif
 }
 
-void t6963c_clear(void) {
-    unsigned short i;
-    t6963c_set_address(0, 0);
-    t6963c_startAutoWrite();
-    for (i = 0; i < t6963c_rows * t6963c_columns; i++) {
-        t6963c_autoWrite(0x00);
+/**
+ * The shadow of a byte of display RAM, or NULL if it is not kept
+ */
+static char* t6963c_shadow_at(T6963C_Display* display,
+        unsigned short address) {
+    unsigned short text_cells = t6963c_text_cells(display);
+    if (address < text_cells)
+        return display->shadow + address;
+    if (address >= display->graphic_home && 
+            address - display->graphic_home < text_cells)
+        return display->shadow_attr + (address - display->graphic_home);
+    return NULL;
+}
+
+unsigned char t6963c_display_readStatus(T6963C_Display* display) {
+    return display->bus.status(display->bus.data);
+}
+
+void t6963c_display_writeByte(T6963C_Display* display, unsigned cd,
+        char byte) {
+    t6963c_display_wait(display);
+    display->bus.write(display->bus.data, cd, byte);
+    t6963c_count(display, commands, cd != 0);
+    t6963c_count(display, data, cd == 0);
+}
+
+void t6963c_display_sendCmd(T6963C_Display* display, char cmd,
+        unsigned char n, char data1, char data2) {
+    char* shadow = t6963c_shadow_at(display, display->address);
+    unsigned char c = cmd;
+    if (c == 0x24 && n == 2) {
+        display->address = (unsigned char) data1 | ((unsigned char) data2 << 8);
+        t6963c_count(display, addresses, 1);
+    } else if (c == 0xb0) {
+        display->auto_write = 1;
+        t6963c_count(display, auto_writes, 1);
+    } else if (c == 0xb2) {
+        display->auto_write = 0;
+    } else if ((c & 0xf8) == 0xc0) {            // data write and read
+        if (!(c & 0x01) && shadow)
+            *shadow = data1;
+        if ((c & 0x06) == 0x00)
+            display->address++;
+        else if ((c & 0x06) == 0x02)
+            display->address--;
+    } else if ((c & 0xf0) == 0xf0 && shadow) {
+        if (c & 0x08)                           // bit set
+            *shadow |= 1 << (c & 0x07);
+        else                                    // bit reset
+            *shadow &= ~(1 << (c & 0x07));
     }
-    t6963c_writeCmd2(0x24, 0x00, 0x03);
-    for (i = 0; i < t6963c_rows * t6963c_columns; i++) {
-        t6963c_autoWrite(t6963c_attr_normal);
+    t6963c_display_wait(display);
+    if (display->bus.command) {
+        display->bus.command(display->bus.data, cmd, n, data1, data2);
+    } else {
+        if (n > 0)
+            display->bus.write(display->bus.data, 0, data1);
+        if (n > 1)
+            display->bus.write(display->bus.data, 0, data2);
+        display->bus.write(display->bus.data, 1, cmd);
     }
-    t6963c_stopAutoWrite();
-    t6963c_set_cursor_address(0, 0);
+    t6963c_count(display, commands, 1);
+    t6963c_count(display, data, n);
 }
 
-void t6963c_init(void) {
+void t6963c_display_sendAuto(T6963C_Display* display, char byte) {
+    char* shadow = t6963c_shadow_at(display, display->address);
+    t6963c_display_wait(display);
+    display->bus.write(display->bus.data, 0, byte);
+    t6963c_count(display, data, 1);
+    if (shadow)
+        *shadow = byte;
+    display->address++;
+}
+
+/**
+ * Write n bytes in auto write mode with one call to the run of the bus, after
+ * waiting for the previous byte. The LCD is then busy with the last byte.
+ */
+static void t6963c_send_run(T6963C_Display* display, const char* bytes,
+        unsigned short n) {
+    unsigned short i;
+    char* shadow;
+    t6963c_display_wait(display);
+    display->bus.run(display->bus.data, (const unsigned char*) bytes, n);
+    t6963c_count(display, data, n);
+    for (i = 0; i < n; i++)
+        if ((shadow = t6963c_shadow_at(display, display->address++)))
+            *shadow = bytes[i];
+}
+
+unsigned t6963c_display_ready(T6963C_Display* display) {
+    unsigned char mask = display->auto_write ? t6963c_sta_auto : t6963c_sta_cmd;
+    return (t6963c_display_readStatus(display) & mask) == mask;
+}
+
+void t6963c_display_writeCmd0(T6963C_Display* display, char cmd) {
+    t6963c_display_sendCmd(display, cmd, 0, 0, 0);
+    t6963c_settle(display, t6963c_sta_cmd, t6963c_cmd_ns);
+}
+
+void t6963c_display_writeCmd1(T6963C_Display* display, char cmd, char data) {
+    t6963c_display_sendCmd(display, cmd, 1, data, 0);
+    t6963c_settle(display, t6963c_sta_cmd, t6963c_cmd_ns);
+}
+
+void t6963c_display_writeCmd2(T6963C_Display* display, char cmd, char data1,
+        char data2) {
+    t6963c_display_sendCmd(display, cmd, 2, data1, data2);
+    t6963c_settle(display, t6963c_sta_cmd, t6963c_cmd_ns);
+}
+
+void t6963c_display_startAutoWrite(T6963C_Display* display) {
+    t6963c_display_sendCmd(display, 0xb0, 0, 0, 0);
+    t6963c_settle(display, t6963c_sta_auto, t6963c_auto_mode_ns);
+}
+
+void t6963c_display_stopAutoWrite(T6963C_Display* display) {
+    t6963c_display_sendCmd(display, 0xb2, 0, 0, 0);
+    t6963c_settle(display, t6963c_sta_cmd, t6963c_auto_mode_ns);
+}
+
+void t6963c_display_autoWrite(T6963C_Display* display, char byte) {
+    t6963c_display_sendAuto(display, byte);
+    t6963c_settle(display, t6963c_sta_auto, t6963c_auto_ns);
+}
+
+void t6963c_display_autoWriteRun(T6963C_Display* display, const char* bytes,
+        unsigned short n) {
     unsigned short i;
+    if (!n)
+        return;
+    if (!display->bus.run) {
+        for (i = 0; i < n; i++)
+            t6963c_display_autoWrite(display, bytes[i]);
+        return;
+    }
+    t6963c_send_run(display, bytes, n);
+    t6963c_settle(display, t6963c_sta_auto, t6963c_auto_ns);
+}
+
+void t6963c_display_set_glyphs(T6963C_Display* display,
+        T6963C_Glyphs* glyphs, const unsigned char* bitmaps,
+        unsigned short count) {
+    if (!count) {
+        display->glyphs = NULL;
+        return;
+    }
+    memset(glyphs, 0, sizeof(T6963C_Glyphs));
+    memset(glyphs->glyph, 0xff, sizeof(glyphs->glyph));
+    glyphs->bitmaps = bitmaps;
+    glyphs->count = count;
+    display->glyphs = glyphs;
+}
+
+/**
+ * Find which codes 0x80.. are on the LCD or in the frame. Their slots should
+ * not be given to another glyph.
+ */
+static void t6963c_glyphs_visible(T6963C_Display* display) {
+    T6963C_Glyphs* glyphs = display->glyphs;
+    unsigned short i, cells = t6963c_cells(display);
+    unsigned char* shadow = (unsigned char*) display->shadow + 
+            display->home * display->columns;
+    unsigned char* frame = (unsigned char*) display->frame;
+    memset(glyphs->visible, 0, sizeof(glyphs->visible));
+    for (i = 0; i < cells; i++) {
+        if (shadow[i] & 0x80)
+            glyphs->visible[(shadow[i] & 0x7f) >> 3] |= 1 << (shadow[i] & 7);
+        if (frame[i] & 0x80)
+            glyphs->visible[(frame[i] & 0x7f) >> 3] |= 1 << (frame[i] & 7);
+    }
+    glyphs->visible_known = 1;
+}
+
+/**
+ * Find the code that shows a glyph. If it is not in CG RAM and assign is set,
+ * give it the least recently used slot that is not visible and has not been
+ * used since the start of the render. It is then uploaded by
+ * t6963c_upload_step().
+ * @return the code, or 0 (a blank) if the glyph has no slot
+ */
+static unsigned char t6963c_glyph_code(T6963C_Display* display,
+        unsigned short glyph, unsigned assign) {
+    T6963C_Glyphs* glyphs = display->glyphs;
+    unsigned char slot, best = t6963c_cg_slots;
     
-    t6963c_t_rst(0);
-    t6963c_t_cd(0);
-    t6963c_t_ce(0);
-    t6963c_t_rd(0);
-    t6963c_t_wr(0);
-    t6963c_t_data(0x00);
+    if (glyph >= glyphs->count)
+        return 0;
+    for (slot = 0; slot < t6963c_cg_slots; slot++) {
+        if (glyphs->glyph[slot] == glyph) {
+            glyphs->used[slot] = ++glyphs->clock;
+            return 0x80 + slot;
+        }
+    }
+    if (!assign)
+        return 0;
     
-    t6963c_wr(1);
-    t6963c_rd(1);
-    t6963c_cd(1);
-    t6963c_ce(1);
+    for (slot = 0; slot < t6963c_cg_slots; slot++) {
+        if (glyphs->used[slot] > glyphs->render)
+            continue;
+        if (glyphs->glyph[slot] != 0xffff) {
+            if (!glyphs->visible_known)
+                t6963c_glyphs_visible(display);
+            if (glyphs->visible[slot >> 3] & (1 << (slot & 7)))
+                continue;
+        }
+        if (best == t6963c_cg_slots || glyphs->used[slot] < glyphs->used[best])
+            best = slot;
+    }
+    if (best == t6963c_cg_slots)
+        return 0;
     
-    t6963c_rst(0);
-    for (i = 0; i < 10; i++)
-        delay_ns(60000);
-    t6963c_rst(1);
+    glyphs->glyph[best] = glyph;
+    glyphs->used[best] = ++glyphs->clock;
+    if (!(glyphs->pending[best >> 3] & (1 << (best & 7)))) {
+        glyphs->pending[best >> 3] |= 1 << (best & 7);
+        glyphs->uploads++;
+    }
+    if (best == glyphs->upload_slot)
+        glyphs->upload_row = 0;
+    return 0x80 + best;
+}
+
+/**
+ * Do one step to upload the glyphs that were given a slot to CG RAM. This
+ * does not wait for the LCD, and may leave it in auto write mode.
+ * @return the time in ns to wait before the next step, or 0 if there is
+ *   nothing left to upload
+ */
+static unsigned long t6963c_upload_step(T6963C_Display* display) {
+    T6963C_Glyphs* glyphs = display->glyphs;
+    unsigned char slot;
+    unsigned short address;
+    
+    if (!glyphs || !glyphs->uploads)
+        return 0;
+    slot = glyphs->upload_slot;
+    if (!(glyphs->pending[slot >> 3] & (1 << (slot & 7)))) {
+        for (slot = 0; !(glyphs->pending[slot >> 3] & (1 << (slot & 7)));)
+            slot++;
+        glyphs->upload_slot = slot;
+        glyphs->upload_row = 0;
+    }
+    
+    address = t6963c_cg_address(display, slot) + glyphs->upload_row;
+    if (display->auto_write) {
+        if (address != display->address) {
+            t6963c_display_sendCmd(display, 0xb2, 0, 0, 0);
+            return t6963c_auto_mode_ns;
+        }
+        t6963c_display_sendAuto(display, glyphs->bitmaps[
+                glyphs->glyph[slot] * 8 + glyphs->upload_row]);
+        if (++glyphs->upload_row == 8) {
+            glyphs->upload_row = 0;
+            glyphs->pending[slot >> 3] &= ~(1 << (slot & 7));
+            glyphs->uploads--;
+        }
+        return t6963c_auto_ns;
+    }
+    if (address != display->address) {
+        t6963c_display_sendCmd(display, 0x24, 2, address & 0xff,
+                address >> 8);
+        return t6963c_cmd_ns;
+    }
+    t6963c_display_sendCmd(display, 0xb0, 0, 0, 0);
+    return t6963c_auto_mode_ns;
+}
+
+/**
+ * Upload the glyphs that were given a slot, and wait for it
+ */
+static void t6963c_upload(T6963C_Display* display) {
+    unsigned long ns;
+    while ((ns = t6963c_upload_step(display)))
+        t6963c_settle(display, display->auto_write ?
+                t6963c_sta_auto : t6963c_sta_cmd, ns);
+    if (display->auto_write)
+        t6963c_display_stopAutoWrite(display);
+}
+
+unsigned char t6963c_display_glyph(T6963C_Display* display,
+        unsigned short glyph) {
+    unsigned char code;
+    if (!display->glyphs)
+        return 0;
+    display->glyphs->visible_known = 0;
+    code = t6963c_glyph_code(display, glyph, 1);
+    t6963c_upload(display);
+    return code;
+}
+
+void t6963c_display_autoWriteChar(T6963C_Display* display, char byte) {
+    if (display->glyphs && (unsigned char) byte >= 0x80)
+        t6963c_display_autoWrite(display, t6963c_glyph_code(display,
+                (unsigned char) byte - 0x80, 0));
+    else
+        t6963c_display_autoWrite(display, byte - 0x20);
+}
+
+void t6963c_display_writeString(T6963C_Display* display, char* string) {
+    char* c;
+    if (display->glyphs) {
+        display->glyphs->render = display->glyphs->clock;
+        display->glyphs->visible_known = 0;
+        for (c = string; *c; c++)
+            if ((unsigned char) *c >= 0x80)
+                t6963c_glyph_code(display, (unsigned char) *c - 0x80, 1);
+        t6963c_upload(display);
+    }
+    t6963c_display_startAutoWrite(display);
+    for (;*string;string++)
+        t6963c_display_autoWriteChar(display, *string);
+    t6963c_display_stopAutoWrite(display);
+}
+
+/**
+ * Let the LCD show the text and attributes from a RAM row on
+ */
+static void t6963c_set_home(T6963C_Display* display, unsigned short row) {
+    unsigned short address = row * display->columns;
+    display->home = display->home_attr = row;
+    t6963c_display_writeCmd2(display, 0x40, address & 0xff, address >> 8);
+    address += display->graphic_home;
+    t6963c_display_writeCmd2(display, 0x42, address & 0xff, address >> 8);
+}
+
+void t6963c_display_clear(T6963C_Display* display) {
+    unsigned short i, text_cells = t6963c_text_cells(display);
+    if (display->home || display->home_attr)
+        t6963c_set_home(display, 0);
+    display->top = 0;
+    t6963c_display_set_address(display, 0, 0);
+    t6963c_display_startAutoWrite(display);
+    for (i = 0; i < text_cells; i++) {
+        t6963c_display_autoWrite(display, 0x00);
+    }
+    t6963c_display_stopAutoWrite(display);
+    if (display->mode == t6963c_mode_attr) {
+        t6963c_display_writeCmd2(display, 0x24, display->graphic_home & 0xff, 
+                display->graphic_home >> 8);
+        t6963c_display_startAutoWrite(display);
+        for (i = 0; i < text_cells; i++) {
+            t6963c_display_autoWrite(display, t6963c_attr_normal);
+        }
+        t6963c_display_stopAutoWrite(display);
+    }
+    t6963c_display_set_cursor_address(display, 0, 0);
+    display->screen = NULL;
+    display->terminal = NULL;
+}
+
+void t6963c_display_init(T6963C_Display* display) {
+    t6963c_initTimer();
     
-    t6963c_writeCmd2(0x40, 0x00, 0x00);             // text home address
-    t6963c_writeCmd2(0x41, t6963c_columns, 0x00);   // text area set
-    t6963c_writeCmd2(0x42, 0x00, 0x03);             // graphic home address
-    t6963c_writeCmd2(0x43, t6963c_columns, 0x00);   // graphic area set
+    display->busy = 0;
+    display->auto_write = 0;
+    display->bus.reset(display->bus.data);
     
-    t6963c_writeByte(1, 0b10000100);    // text attribute, internal ROM
-    t6963c_writeByte(1, 0b10011111);    // graphic, text, cursor, blink
-    t6963c_writeByte(1, 0xa7);          // 8-line cursor
+    t6963c_display_writeCmd2(display, 0x40, 0x00, 0x00); // text home address
+    t6963c_display_writeCmd2(display, 0x41, display->columns, 0x00); // text area
+    t6963c_display_writeCmd2(display, 0x42, display->graphic_home & 0xff, 
+            display->graphic_home >> 8);        // graphic home address
+    t6963c_display_writeCmd2(display, 0x43, display->columns, 0x00); // graphic area
+    t6963c_display_writeCmd2(display, 0x22, display->cg_offset, 0x00); // CG RAM
+    display->home = display->home_attr = 0;
     
-    t6963c_clear();
+    t6963c_display_set_mode(display, t6963c_mode_attr); // text attribute, ROM
+    t6963c_display_writeCmd0(display, 0b10011111); // graphic, text, cursor, blink
+    t6963c_display_writeCmd0(display, 0xa7);       // 8-line cursor
     
-    t6963c_set_address(0, 0);
-    t6963c_set_cursor_address(0, 0);
+    t6963c_display_clear(display);
     
-    t6963c_initTimer(); 
+    t6963c_display_set_address(display, 0, 0);
+    t6963c_display_set_cursor_address(display, 0, 0);
 }
 
-void t6963c_set_address(unsigned char row, unsigned char column) {
-    unsigned short address = 
-            ((unsigned short) row) * ((unsigned short) t6963c_columns) + column;
-    t6963c_writeCmd2(0x24, address & 0xff, ((address >> 8) & 0xff));
+void t6963c_display_set_mode(T6963C_Display* display, unsigned char mode) {
+    t6963c_display_writeCmd0(display, 0x80 | mode);
+    display->mode = mode;
+    // Graphics do not scroll with the text
+    if (mode != t6963c_mode_attr && display->home_attr) {
+        display->home_attr = 0;
+        t6963c_display_writeCmd2(display, 0x42, display->graphic_home & 0xff, 
+                display->graphic_home >> 8);
+    }
 }
 
-void t6963c_set_cursor_address(unsigned char row, unsigned char column) {
-    t6963c_writeCmd2(0x21, column, row);
+unsigned short t6963c_display_get_address(T6963C_Display* display) {
+    return display->address;
 }
 
-void t6963c_update_terminal(Terminal* term) {
-    unsigned int i;
+/*
+ * Outside text attribute mode, home_attr is the pixel row of the graphic area
+ * that is shown at the top, and a page is 8 pixel rows per text row.
+ */
+
+void t6963c_display_show_page(T6963C_Display* display, unsigned char page) {
+    unsigned short address;
+    display->home_attr = page * 8 * display->rows;
+    address = display->graphic_home + display->home_attr * display->columns;
+    t6963c_display_writeCmd2(display, 0x42, address & 0xff, address >> 8);
+}
+
+unsigned char t6963c_display_page(T6963C_Display* display) {
+    return display->home_attr / (8 * display->rows);
+}
+
+void t6963c_display_set_address(T6963C_Display* display, unsigned char row,
+        unsigned char column) {
+    unsigned short address = ((unsigned short) (row + display->home)) * 
+            ((unsigned short) display->columns) + column;
+    t6963c_display_writeCmd2(display, 0x24, address & 0xff,
+            ((address >> 8) & 0xff));
+}
+
+void t6963c_display_set_cursor_address(T6963C_Display* display,
+        unsigned char row, unsigned char column) {
+    display->cursor_row = row;
+    display->cursor_column = column;
+    t6963c_display_writeCmd2(display, 0x21, column, row);
+}
+
+/*
+ * The cells that are synced are numbered from 0: first the text, and in text
+ * attribute mode the attributes after that. These give the frame, the shadow
+ * and the address of such a cell.
+ */
+
+static inline char* t6963c_frame_of(T6963C_Display* display,
+        unsigned short cell) {
+    unsigned short cells = t6963c_cells(display);
+    return cell < cells ? display->frame + cell : 
+            display->frame_attr + (cell - cells);
+}
+
+static inline char* t6963c_shadow_of(T6963C_Display* display,
+        unsigned short cell) {
+    unsigned short cells = t6963c_cells(display);
+    unsigned short origin = display->top * display->columns;
+    return cell < cells ? display->shadow + origin + cell : 
+            display->shadow_attr + origin + (cell - cells);
+}
+
+static inline unsigned short t6963c_address_of(T6963C_Display* display,
+        unsigned short cell) {
+    unsigned short cells = t6963c_cells(display);
+    unsigned short address = display->top * display->columns + cell;
+    if (cell >= cells)
+        address += display->graphic_home - cells;
+    return address;
+}
+
+/**
+ * The first step of the quickest way to write the changed cells from
+ * sync_cell on, as planned by t6963c_plan(). Only the changes up to a longer
+ * gap than t6963c_max_gap are planned, since no run is worth continuing over
+ * it; text and attributes are planned separately.
+ */
+static T6963C_Step t6963c_sync_plan(T6963C_Display* display, unsigned short n) {
+    T6963C_Span spans[t6963c_plan_size];
+    T6963C_Plan plan;
+    unsigned short cells = t6963c_cells(display);
+    unsigned short cell, last, address;
+    unsigned char k = 0;
+    
+    n = display->sync_cell < cells ? cells : n;
+    for (cell = last = display->sync_cell; 
+            cell < n && cell - last <= t6963c_max_gap; cell++) {
+        if (*t6963c_frame_of(display, cell) == *t6963c_shadow_of(display, cell))
+            continue;
+        address = t6963c_address_of(display, cell);
+        if (k && address == spans[k - 1].address + spans[k - 1].length) {
+            spans[k - 1].length++;
+        } else if (k == t6963c_plan_size) {
+            break;
+        } else {
+            spans[k].address = address;
+            spans[k].length = 1;
+            spans[k++].bits = 0;
+        }
+        last = cell;
+    }
+    t6963c_plan(&plan, spans, k, display->address);
+    return plan.steps[0];
+}
+
+/**
+ * A step of t6963c_display_sync_step. With runs and a bus backend that writes
+ * runs, an auto write step writes all cells up to the last change that can be
+ * reached without a longer gap than t6963c_max_gap.
+ */
+static unsigned long t6963c_sync_next(T6963C_Display* display, unsigned runs) {
+    unsigned short cells = t6963c_cells(display);
+    unsigned short origin = display->top * display->columns;
+    unsigned short n = display->mode == t6963c_mode_attr ? 2 * cells : cells;
+    unsigned short address, cell, last;
+    unsigned long write;
+    T6963C_Step step;
+    char* gap;
+    
+    // New glyphs are uploaded before the cells that show them are written
+    if ((write = t6963c_upload_step(display)))
+        return write;
+    
+    while (display->sync_cell < n && *t6963c_frame_of(display, 
+            display->sync_cell) == *t6963c_shadow_of(display, display->sync_cell))
+        display->sync_cell++;
+    
+    if (display->sync_cell == n) {
+        if (display->auto_write) {
+            t6963c_display_sendCmd(display, 0xb2, 0, 0, 0);
+            return t6963c_auto_mode_ns;
+        }
+        // Only show the new rows once they have been written
+        if (display->home != display->top) {
+            display->home = display->top;
+            t6963c_display_sendCmd(display, 0x40, 2, origin & 0xff,
+                    origin >> 8);
+            return t6963c_cmd_ns;
+        }
+        if (display->mode == t6963c_mode_attr && 
+                display->home_attr != display->top) {
+            display->home_attr = display->top;
+            origin += display->graphic_home;
+            t6963c_display_sendCmd(display, 0x42, 2, origin & 0xff,
+                    origin >> 8);
+            return t6963c_cmd_ns;
+        }
+        if (display->frame_row != display->cursor_row || 
+                display->frame_column != display->cursor_column) {
+            display->cursor_row = display->frame_row;
+            display->cursor_column = display->frame_column;
+            t6963c_display_sendCmd(display, 0x21, 2, display->frame_column,
+                    display->frame_row);
+            return t6963c_cmd_ns;
+        }
+        return 0;
+    }
+    
+    address = t6963c_address_of(display, display->sync_cell);
+    if (display->auto_write && address == display->address && runs &&
+            display->bus.run) {
+        // Text and attributes are not contiguous in RAM
+        n = display->sync_cell < cells ? cells : n;
+        for (cell = last = display->sync_cell; 
+                cell < n && cell - last <= t6963c_max_gap; cell++)
+            if (*t6963c_frame_of(display, cell) != 
+                    *t6963c_shadow_of(display, cell))
+                last = cell;
+        t6963c_send_run(display, t6963c_frame_of(display, display->sync_cell),
+                last - display->sync_cell + 1);
+        display->sync_cell = last + 1;
+        return t6963c_auto_ns;
+    }
+    if (display->auto_write) {
+        if (address == display->address) {
+            t6963c_display_sendAuto(display, 
+                    *t6963c_frame_of(display, display->sync_cell++));
+            return t6963c_auto_ns;
+        }
+        // Rewriting a short gap is cheaper than setting a new address
+        gap = t6963c_shadow_at(display, display->address);
+        if (gap && address > display->address && 
+                address - display->address <= t6963c_max_gap) {
+            t6963c_display_sendAuto(display, *gap);
+            return t6963c_auto_ns;
+        }
+        t6963c_display_sendCmd(display, 0xb2, 0, 0, 0);
+        return t6963c_auto_mode_ns;
+    }
+    
+    if (address != display->address) {
+        t6963c_display_sendCmd(display, 0x24, 2, address & 0xff,
+                ((address >> 8) & 0xff));
+        return t6963c_cmd_ns;
+    }
+    
+    // Data writes (0xC0) of a span that was planned that way
+    if (display->sync_cell >= display->write_end) {
+        step = t6963c_sync_plan(display, n);
+        if (step.type == t6963c_step_auto) {
+            t6963c_display_sendCmd(display, 0xb0, 0, 0, 0);
+            return t6963c_auto_mode_ns;
+        }
+        display->write_end = display->sync_cell + step.length;
+    }
+    t6963c_display_sendCmd(display, 0xc0, 1, 
+            *t6963c_frame_of(display, display->sync_cell++), 0);
+    return t6963c_cmd_ns;
+}
+
+unsigned long t6963c_display_sync_step(T6963C_Display* display) {
+    return t6963c_sync_next(display, 0);
+}
+
+/**
+ * The code that shows a character: ASCII from the CG ROM, or a custom glyph
+ */
+static char t6963c_code(T6963C_Display* display, char c) {
+    if (display->glyphs && (unsigned char) c >= 0x80)
+        return t6963c_glyph_code(display, (unsigned char) c - 0x80, 1);
+    return c - 0x20;
+}
+
+/**
+ * The number of line starts to index for rows rows: one more than fit, so that
+ * the start of the top row is known after a line was appended. The index holds
+ * at most t6963c_rows + 1; a larger display scans for the rest.
+ */
+static unsigned int t6963c_index_size(unsigned char rows) {
+    return rows < t6963c_rows ? rows + 1 : t6963c_rows + 1;
+}
+
+void t6963c_display_render_terminal(T6963C_Display* display, Terminal* term) {
+    unsigned short cells = t6963c_cells(display);
+    unsigned char rows = display->rows, columns = display->columns;
+    unsigned int i, size, scroll = 0;
+    unsigned short cell;
+    char c;
+    
+    if (term->row_length != columns)
+        terminal.index_lines(term, columns, display->index,
+                t6963c_index_size(rows));
+    i = terminal.visible_start(term, columns, rows);
+    if (i && term == display->terminal && term->base == display->first)
+        scroll = terminal.lines(term, columns) - rows;
+    terminal.drop(term, i);
+    if (display->glyphs) {
+        display->glyphs->render = display->glyphs->clock;
+        display->glyphs->visible_known = 0;
+    }
+    
+    // Scroll by moving the home address, when there is RAM for it
+    if (display->text_rows > rows && scroll && scroll < rows) {
+        display->top += scroll;
+        if (display->top + rows > display->text_rows)
+            display->top = 0;
+    }
+    
+    // When only characters were appended, the frame is still right up to them
+    if (term == display->terminal && term->base == display->first &&
+            !term->change.discarded && term->change.from == display->end) {
+        i = display->end - display->first;
+        cell = display->end_cell;
+    } else {
+        i = 0;
+        cell = 0;
+    }
+    
+    size = terminal.size(term);
+    for (; i < size && cell < cells; i++) {
+        c = terminal.char_at(term, i);
+        if (c == '\n') {
+            do {
+                display->frame_attr[cell] = t6963c_attr_normal;
+                display->frame[cell++] = ' ' - 0x20;
+            } while (cell % columns);
+            continue;
+        }
+        display->frame_attr[cell] = terminal.attribute_at(term, i);
+        display->frame[cell++] = t6963c_code(display, c);
+    }
+    display->screen = NULL;
+    display->terminal = term;
+    display->first = term->base;
+    display->end = term->base + i;
+    display->end_cell = cell;
+    display->frame_row = cell / columns;
+    display->frame_column = cell % columns;
+    while (cell < cells) {
+        display->frame_attr[cell] = t6963c_attr_normal;
+        display->frame[cell++] = ' ' - 0x20;
+    }
+    display->sync_cell = 0;
+    display->write_end = 0;
+    display->synced = 0;
+}
+
+/**
+ * Do a step of t6963c_display_sync_step, and remember how long the LCD is busy
+ * with it
+ */
+static void t6963c_sync(T6963C_Display* display) {
+    unsigned long ns = t6963c_sync_next(display, 1);
+    if (ns)
+        t6963c_settle(display, display->auto_write ?
+                t6963c_sta_auto : t6963c_sta_cmd, ns);
+    else
+        display->synced = 1;
+}
+
+#ifdef t6963c_stats
+static void t6963c_update_begin(T6963C_Display* display) {
+    display->update_at = t6963c_timestamp();
+    display->update_bytes = t6963c_bytes(display);
+}
+
+/**
+ * Count the bytes and time since t6963c_update_begin in the histograms
+ */
+static void t6963c_update_end(T6963C_Display* display) {
+    unsigned long bytes = t6963c_bytes(display) - display->update_bytes;
+    unsigned long ns = 
+            (t6963c_timestamp() - display->update_at) * t6963c_nspertick;
+    unsigned char i;
+    display->stats.updates++;
+    for (i = 0; i < t6963c_histogram_size - 1 && 
+            bytes >= (unsigned long) t6963c_histogram_bytes << i; i++);
+    display->stats.update_bytes[i]++;
+    for (i = 0; i < t6963c_histogram_size - 1 && 
+            ns >= (unsigned long) t6963c_histogram_ns << i; i++);
+    display->stats.update_ns[i]++;
+}
+
+void t6963c_display_get_stats(T6963C_Display* display, T6963C_Stats* stats) {
+    *stats = display->stats;
+}
+
+void t6963c_display_reset_stats(T6963C_Display* display) {
+    memset(&display->stats, 0, sizeof(T6963C_Stats));
+}
+#else
+#define t6963c_update_begin(display)
+#define t6963c_update_end(display)
+#endif
+
+void t6963c_display_update_terminal(T6963C_Display* display, Terminal* term) {
+    t6963c_update_begin(display);
+    t6963c_display_render_terminal(display, term);
+    while (!display->synced)
+        t6963c_sync(display);
+    t6963c_update_end(display);
+}
+
+void t6963c_update_terminal_display(Terminal* term) {
+    t6963c_display_update_terminal((T6963C_Display*) term->data, term);
+}
+
+/**
+ * The text attribute that shows the screen_* attributes of a Screen cell
+ */
+static unsigned char t6963c_screen_attribute(unsigned char attributes) {
+    unsigned char attribute = t6963c_attr_normal;
+    if (attributes & screen_hidden)
+        attribute = t6963c_attr_inhibit;
+    else if (attributes & screen_reverse)
+        attribute = t6963c_attr_invert;
+    if (attributes & screen_blink)
+        attribute |= t6963c_attr_blink;
+    return attribute;
+}
+
+void t6963c_display_render_screen(T6963C_Display* display, Screen* scr) {
+    unsigned short cells = t6963c_cells(display);
+    unsigned short cell, from = scr->changed_from, to = scr->changed_to;
     unsigned char row, column;
     
-    while (terminal.lines_needed(term->content, t6963c_columns) > t6963c_rows)
-        terminal.discard_first_line(term->content, t6963c_columns);
-    
-    row = 0;
-    column = 0;
-    t6963c_set_address(0, 0);
-    t6963c_startAutoWrite();
-    for (i=0; term->content[i]; i++) {
-        if (term->content[i] == '\n') {
-            t6963c_autoWriteChar(' ');
-            while ((column = (column + 1) % t6963c_columns))
-                t6963c_autoWriteChar(' ');
-            row++;
+    if (scr != display->screen) {
+        // The frame holds something else: render everything
+        memset(display->frame, ' ' - 0x20, cells);
+        memset(display->frame_attr, t6963c_attr_normal, cells);
+        from = 0;
+        to = scr->rows * scr->columns;
+    }
+    if (display->glyphs) {
+        display->glyphs->render = display->glyphs->clock;
+        display->glyphs->visible_known = 0;
+    }
+    
+    for (cell = from; cell < to; cell++) {
+        if (scr == display->screen && !screen.changed(scr, cell))
+            continue;
+        row = cell / scr->columns;
+        column = cell % scr->columns;
+        if (row >= display->rows || column >= display->columns)
+            continue;
+        display->frame[row * display->columns + column] = 
+                t6963c_code(display, scr->chars[cell]);
+        display->frame_attr[row * display->columns + column] =
+                t6963c_screen_attribute(scr->attributes[cell]);
+    }
+    
+    display->sync_cell = 0;
+    display->write_end = 0;
+    display->synced = 0;
+    display->screen = scr;
+    display->terminal = NULL;
+    display->frame_row = scr->row < display->rows ? 
+            scr->row : display->rows - 1;
+    display->frame_column = scr->column < display->columns ? 
+            scr->column : display->columns - 1;
+}
+
+void t6963c_display_update_screen(T6963C_Display* display, Screen* scr) {
+    t6963c_update_begin(display);
+    t6963c_display_render_screen(display, scr);
+    while (!display->synced)
+        t6963c_sync(display);
+    t6963c_update_end(display);
+}
+
+void t6963c_update_screen_display(Screen* scr) {
+    t6963c_display_update_screen((T6963C_Display*) scr->data, scr);
+}
+
+void t6963c_update_terminals(T6963C_Display* const* displays,
+        Terminal* const* terms, unsigned char n) {
+    unsigned char i, left = n;
+    for (i = 0; i < n; i++)
+        t6963c_display_render_terminal(displays[i], terms[i]);
+    while (left)
+        for (i = 0; i < n; i++)
+            if (!displays[i]->synced && t6963c_display_idle(displays[i])) {
+                t6963c_sync(displays[i]);
+                if (displays[i]->synced)
+                    left--;
+            }
+}
+
+void t6963c_window_setup(T6963C_Window* window, T6963C_Display* display,
+        unsigned char row, unsigned char column, unsigned char rows,
+        unsigned char columns, Terminal* term) {
+    window->display = display;
+    window->row = row;
+    window->column = column;
+    window->rows = rows;
+    window->columns = columns;
+    window->terminal = term;
+    window->cursor = 0;
+    window->stale = 1;
+    term->data = window;
+}
+
+void t6963c_render_window(T6963C_Window* window) {
+    T6963C_Display* display = window->display;
+    Terminal* term = window->terminal;
+    unsigned char rows = window->rows, columns = window->columns;
+    unsigned short start = window->row * display->columns + window->column;
+    unsigned short cell = start;
+    unsigned char row = 0, column = 0;
+    unsigned int i, size;
+    char c;
+    
+    if (term->row_length != columns)
+        terminal.index_lines(term, columns, window->index,
+                t6963c_index_size(rows));
+    terminal.drop(term, terminal.visible_start(term, columns, rows));
+    if (display->glyphs) {
+        display->glyphs->render = display->glyphs->clock;
+        display->glyphs->visible_known = 0;
+    }
+    
+    size = terminal.size(term);
+    for (i = 0; i <= size && row < rows; i++) {
+        c = i < size ? terminal.char_at(term, i) : '\n';
+        if (c == '\n') {
+            if (i == size && window->cursor) {
+                display->frame_row = window->row + row;
+                display->frame_column = window->column + column;
+            }
+            for (; column < columns; column++, cell++) {
+                display->frame_attr[cell] = t6963c_attr_normal;
+                display->frame[cell] = ' ' - 0x20;
+            }
         } else {
-            t6963c_autoWriteChar(term->content[i]);
-            column = (column + 1) % t6963c_columns;
-            if (column == 0)
-                row++;
-        }
-    }
-    t6963c_stopAutoWrite();
-    t6963c_set_cursor_address(row, column);
-    t6963c_startAutoWrite();
-    while (row != t6963c_rows) {
-        t6963c_autoWriteChar(' ');
-        column = (column + 1) % t6963c_columns;
-        if (column == 0)
+            display->frame_attr[cell] = terminal.attribute_at(term, i);
+            display->frame[cell++] = t6963c_code(display, c);
+            column++;
+        }
+        if (column == columns) {
+            column = 0;
             row++;
+            cell += display->columns - columns;
+        }
     }
-    t6963c_stopAutoWrite();
+    // The rows below the end of the Terminal
+    for (; row < rows; row++, cell += display->columns - columns)
+        for (column = 0; column < columns; column++, cell++) {
+            display->frame_attr[cell] = t6963c_attr_normal;
+            display->frame[cell] = ' ' - 0x20;
+        }
+    
+    window->stale = 0;
+    display->screen = NULL;
+    display->terminal = NULL;
+    if (display->synced || display->sync_cell > start)
+        display->sync_cell = start;
+    display->write_end = 0;
+    display->synced = 0;
+}
+
+void t6963c_update_window(Terminal* term) {
+    T6963C_Window* window = (T6963C_Window*) term->data;
+    T6963C_Display* display = window->display;
+    t6963c_update_begin(display);
+    t6963c_render_window(window);
+    while (!display->synced)
+        t6963c_sync(display);
+    t6963c_update_end(display);
+}
+
+void t6963c_mark_window(Terminal* term) {
+    ((T6963C_Window*) term->data)->stale = 1;
+}
+
+void t6963c_compose(T6963C_Window* const* windows, unsigned char n) {
+    unsigned char i;
+    for (i = 0; i < n; i++)
+        if (windows[i]->stale)
+            t6963c_render_window(windows[i]);
+    for (i = 0; i < n; i++)
+        while (!windows[i]->display->synced)
+            t6963c_sync(windows[i]->display);
+}
+
+/*
+ * The functions on the default display
+ */
+
+unsigned char t6963c_readStatus(void) {
+    return t6963c_display_readStatus(&t6963c_default);
+}
+
+void t6963c_writeByte(unsigned cd, char byte) {
+    t6963c_display_writeByte(&t6963c_default, cd, byte);
+}
+
+void t6963c_sendCmd(char cmd, unsigned char n, char data1, char data2) {
+    t6963c_display_sendCmd(&t6963c_default, cmd, n, data1, data2);
+}
+
+void t6963c_sendAuto(char byte) {
+    t6963c_display_sendAuto(&t6963c_default, byte);
+}
+
+unsigned t6963c_ready(void) {
+    return t6963c_display_ready(&t6963c_default);
+}
+
+void t6963c_writeCmd0(char cmd) {
+    t6963c_display_writeCmd0(&t6963c_default, cmd);
+}
+
+void t6963c_writeCmd1(char cmd, char data) {
+    t6963c_display_writeCmd1(&t6963c_default, cmd, data);
+}
+
+void t6963c_writeCmd2(char cmd, char data1, char data2) {
+    t6963c_display_writeCmd2(&t6963c_default, cmd, data1, data2);
+}
+
+void t6963c_startAutoWrite(void) {
+    t6963c_display_startAutoWrite(&t6963c_default);
+}
+
+void t6963c_stopAutoWrite(void) {
+    t6963c_display_stopAutoWrite(&t6963c_default);
+}
+
+void t6963c_autoWrite(char byte) {
+    t6963c_display_autoWrite(&t6963c_default, byte);
+}
+
+void t6963c_autoWriteRun(const char* bytes, unsigned short n) {
+    t6963c_display_autoWriteRun(&t6963c_default, bytes, n);
+}
+
+inline void t6963c_autoWriteChar(char byte) {
+    t6963c_display_autoWriteChar(&t6963c_default, byte);
+}
+
+void t6963c_writeString(char* string) {
+    t6963c_display_writeString(&t6963c_default, string);
+}
+
+void t6963c_clear(void) {
+    t6963c_display_clear(&t6963c_default);
+}
+
+void t6963c_init(void) {
+    t6963c_display_init(&t6963c_default);
+}
+
+void t6963c_set_mode(unsigned char mode) {
+    t6963c_display_set_mode(&t6963c_default, mode);
+}
+
+unsigned short t6963c_get_address(void) {
+    return t6963c_display_get_address(&t6963c_default);
+}
+
+void t6963c_show_page(unsigned char page) {
+    t6963c_display_show_page(&t6963c_default, page);
+}
+
+unsigned char t6963c_page(void) {
+    return t6963c_display_page(&t6963c_default);
+}
+
+void t6963c_set_address(unsigned char row, unsigned char column) {
+    t6963c_display_set_address(&t6963c_default, row, column);
 }
 
+void t6963c_set_cursor_address(unsigned char row, unsigned char column) {
+    t6963c_display_set_cursor_address(&t6963c_default, row, column);
+}
+
+unsigned long t6963c_sync_step(void) {
+    return t6963c_display_sync_step(&t6963c_default);
+}
+
+void t6963c_render_terminal(Terminal* term) {
+    t6963c_display_render_terminal(&t6963c_default, term);
+}
+
+void t6963c_update_terminal(Terminal* term) {
+    t6963c_display_update_terminal(&t6963c_default, term);
+}
+
+void t6963c_render_screen(Screen* scr) {
+    t6963c_display_render_screen(&t6963c_default, scr);
+}
+
+void t6963c_update_screen(Screen* scr) {
+    t6963c_display_update_screen(&t6963c_default, scr);
+}
+
+void t6963c_set_glyphs(T6963C_Glyphs* glyphs, const unsigned char* bitmaps,
+        unsigned short count) {
+    t6963c_display_set_glyphs(&t6963c_default, glyphs, bitmaps, count);
+}
+
+unsigned char t6963c_glyph(unsigned short glyph) {
+    return t6963c_display_glyph(&t6963c_default, glyph);
+}
+
+#ifdef t6963c_stats
+void t6963c_get_stats(T6963C_Stats* stats) {
+    t6963c_display_get_stats(&t6963c_default, stats);
+}
+
+void t6963c_reset_stats(void) {
+    t6963c_display_reset_stats(&t6963c_default);
+}
+#endif
@@ -29,9 +29,27 @@
  * pins you are using for what function. Also, timer functions should be written
  * in a t6963c_specific.c. The rationale is to separate the generic and the 
  * project-specific code.
+ * 
+ * By default, fixed worst-case delays are used after every command and byte.
+ * When t6963c_status_check is defined, the status byte is polled instead, and
+ * the delays are only used as timeouts. This requires a data port that can be
+ * read with t6963c_data_in().
+ *
+ * Every function works on a T6963C_Display: the geometry and RAM layout of one
+ * LCD, the bus it is connected to and the state of the driver. The functions
+ * without display argument work on t6963c_default, which uses the pins of
+ * t6963c_specific.h. The delay after a byte is only waited for right before
+ * the next byte is sent to the same display, so that another display can be
+ * written in the meantime.
+ *
+ * When t6963c_stats is defined, every display counts the bytes sent to it and
+ * the time spent waiting for it, and keeps histograms of the bytes and time of
+ * blocking updates. Read them with t6963c_display_get_stats(). Without
+ * t6963c_stats, none of this is compiled.
  */
 
 #include "terminal.h"
+#include "screen.h"
 #include <t6963c_specific.h>
 
 #ifndef T6963C_H
@@ -43,28 +61,16 @@ extern "C" {
         
 /**
  * To be written by someone implementing this library.
- * Initialise the timer for the delay functions
+ * Start the free-running timer that t6963c_timestamp() reads, if needed.
  */
 extern inline void t6963c_initTimer(void);
    
 /**
  * To be written by someone implementing this library.
- * Start the timer for the delay functions
- */
-extern inline void t6963c_startTimer(void);
-   
-/**
- * To be written by someone implementing this library.
- * Get the amount of ns (nano seconds) elapsed since starting the timer with
- * t6963c_startTimer().
- */
-extern inline unsigned short t6963c_getTimeNs(void);
-   
-/**
- * To be written by someone implementing this library.
- * Stop the timer for the delay functions
+ * Read a free-running timer that counts up by one every t6963c_nspertick ns
+ * and wraps around. It is never reconfigured by the library.
  */
-extern inline void t6963c_stopTimer(void);
+extern inline unsigned long t6963c_timestamp(void);
 
 #ifndef t6963c_rst
 extern inline void t6963c_rst(unsigned);
@@ -80,6 +86,7 @@ extern inline void t6963c_t_wr(unsigned);
 
 extern inline void t6963c_data(unsigned int);
 extern inline void t6963c_t_data(unsigned int);
+extern inline unsigned char t6963c_data_in(void);
 #endif
 
 #ifndef t6963c_rows
@@ -89,6 +96,128 @@ extern inline void t6963c_t_data(unsigned int);
 #define t6963c_columns 40
 #endif
 
+/**
+ * The number of rows in the text RAM. When this is larger than t6963c_rows,
+ * t6963c_update_terminal scrolls by writing the new rows below the screen and
+ * moving the text home address, instead of rewriting the whole screen. When
+ * the end of the text RAM is reached, the screen is written at the top again.
+ */
+#ifndef t6963c_text_rows
+#define t6963c_text_rows t6963c_rows
+#endif
+
+/**
+ * The start of the graphic area, which holds the attributes in text attribute
+ * mode. By default this is the first multiple of 0x100 after the text RAM.
+ */
+#ifndef t6963c_graphic_home
+#define t6963c_graphic_home \
+        ((t6963c_text_rows * t6963c_columns + 0xff) & 0xff00)
+#endif
+
+/**
+ * The number of pages of pixels in the graphic area, 1 or 2. With 2 pages,
+ * t6963c_graphics_flush() writes the page that is not shown and then shows it,
+ * so that a frame is never seen half drawn. This needs RAM for two screens of
+ * pixels after the graphic home address.
+ */
+#ifndef t6963c_graphic_pages
+#define t6963c_graphic_pages 1
+#endif
+
+/**
+ * The number of custom glyphs that can be in CG RAM at the same time, at most
+ * 128. They are shown with the codes 0x80 and up, which the T6963C takes from
+ * CG RAM, also when the internal CG ROM is used for the other codes.
+ */
+#ifndef t6963c_cg_slots
+#define t6963c_cg_slots 128
+#endif
+
+/**
+ * The value of the offset register (0x22). The CG RAM is the 2KB block of RAM
+ * it selects, and the custom glyphs are in its upper half. By default this is
+ * the first block of which the upper half comes after the graphic area, with
+ * room for 8 pixel rows per text row.
+ */
+#ifndef t6963c_cg_offset
+#define t6963c_cg_offset ((t6963c_graphic_home + (t6963c_text_rows + \
+        (t6963c_graphic_pages - 1) * t6963c_rows) * t6963c_columns * 8 + \
+        0x3ff) >> 11)
+#endif
+
+/**
+ * The largest number of unchanged cells t6963c_update_terminal() rewrites to
+ * bridge two changed runs. Setting a new address costs a stop, an address set
+ * and a start (about 300us), where one auto write costs about 6.4us.
+ */
+#ifndef t6963c_max_gap
+#define t6963c_max_gap 47
+#endif
+
+/**
+ * The time in ns the data port is given to settle when reading the status.
+ * Polling the status takes at least this long.
+ */
+#ifndef t6963c_status_ns
+#define t6963c_status_ns 150
+#endif
+
+// Bus timing in ns: C/D setup before CE (tAS), the CE pulse width (tCE) and
+// the data hold time after CE (tDH)
+#ifndef t6963c_tas_ns
+#define t6963c_tas_ns 100
+#endif
+#ifndef t6963c_tce_ns
+#define t6963c_tce_ns 80
+#endif
+#ifndef t6963c_tdh_ns
+#define t6963c_tdh_ns 40
+#endif
+
+// Delays in ns after a command, after entering or leaving auto mode, and after
+// an auto write. With status checking, these are the timeouts.
+#define t6963c_cmd_ns 60000
+#define t6963c_auto_mode_ns 120000
+#define t6963c_auto_ns 6000
+
+/**
+ * The number of timer ticks to wait for at least ns ns. A tick may already
+ * have partly passed when the wait starts, so one is added.
+ */
+#define t6963c_ticks(ns) \
+        (((unsigned long) (ns) + t6963c_nspertick - 1) / t6963c_nspertick + 1)
+
+/**
+ * Wait for at least ns ns. With a constant, the number of ticks is computed
+ * at compile time.
+ */
+#define t6963c_wait(ns) t6963c_wait_ticks(t6963c_ticks(ns))
+
+// The time in ns to put one byte on the bus, in t6963c_writeByte()
+#define t6963c_byte_ns (t6963c_tas_ns + t6963c_tce_ns + t6963c_tdh_ns)
+
+// Estimated bus time in ns of setting the address pointer, an auto write run
+// of n bytes, n data writes (0xC0) and n bit set or reset commands
+#define t6963c_cost_address (3 * t6963c_byte_ns + t6963c_cmd_ns)
+#define t6963c_cost_auto(n) (2 * (t6963c_byte_ns + t6963c_auto_mode_ns) + \
+        (unsigned long) (n) * (t6963c_byte_ns + t6963c_auto_ns))
+#define t6963c_cost_write(n) \
+        ((unsigned long) (n) * (2 * t6963c_byte_ns + t6963c_cmd_ns))
+#define t6963c_cost_bit(n) \
+        ((unsigned long) (n) * (t6963c_byte_ns + t6963c_cmd_ns))
+
+// Status bits
+#define t6963c_sta_cmd 0x03     // STA0 and STA1: ready for commands and data
+#define t6963c_sta_auto 0x08    // STA3: ready for auto write
+
+// Mode set definitions. In text attribute mode the graphic area holds the
+// attributes; in the other modes it holds pixels, combined with the text.
+#define t6963c_mode_or 0x00
+#define t6963c_mode_exor 0x01
+#define t6963c_mode_and 0x03
+#define t6963c_mode_attr 0x04
+
 // Text attribute mode definitions
 #define t6963c_attr_normal 0x00
 #define t6963c_attr_invert 0x05
@@ -98,12 +227,265 @@ extern inline void t6963c_t_data(unsigned int);
 #define t6963c_attr_bl_inhibit 0x0b
         
 /**
- * Write a single byte to the LCD
+ * Wait for ticks ticks of the timer
+ */
+static inline void t6963c_wait_ticks(unsigned long ticks) {
+    unsigned long start = t6963c_timestamp();
+    while (t6963c_timestamp() - start < ticks);
+}
+
+/**
+ * The connection to an LCD. The pin backend of t6963c_specific.h is
+ * t6963c_pins; other backends may drive a second set of pins, a port expander
+ * or a simulated controller.
+ *
+ * A backend may also write whole commands and auto write runs at once, for
+ * example with a parallel master port or DMA. command sends the data bytes and
+ * then the command byte. run writes n bytes in auto write mode; the LCD is
+ * ready for the first, and the backend waits for it between the others, by
+ * t6963c_auto_ns or its status. When these are NULL, write is used.
+ */
+typedef struct T6963C_Bus {
+    void (*write)(void* data, unsigned cd, unsigned char byte); // write a byte
+    unsigned char (*status)(void* data); // read the status, NULL if impossible
+    void (*reset)(void* data);           // set up the pins and reset the LCD
+    void* data;                          // passed to the functions
+    void (*command)(void* data, unsigned char cmd, unsigned char n,
+            unsigned char data1, unsigned char data2); // or NULL
+    void (*run)(void* data, const unsigned char* bytes,
+            unsigned short n);           // or NULL
+} T6963C_Bus;
+
+#ifdef t6963c_stats
+#ifndef t6963c_histogram_size
+#define t6963c_histogram_size 8         // Number of buckets of a histogram
+#endif
+#ifndef t6963c_histogram_bytes
+#define t6963c_histogram_bytes 16       // Bytes of the first bucket
+#endif
+#ifndef t6963c_histogram_ns
+#define t6963c_histogram_ns 1000000     // ns of the first bucket
+#endif
+
+/**
+ * Counters of a display. Bucket i of a histogram counts the updates that took
+ * less than 2^i times the first bucket, except for the last, which counts the
+ * rest.
+ */
+typedef struct T6963C_Stats {
+    unsigned long commands;             // command bytes sent
+    unsigned long data;                 // data bytes sent, also in auto mode
+    unsigned long auto_writes;          // auto write runs started
+    unsigned long addresses;            // times the address pointer was set
+    unsigned long long wait_ns;         // time spent waiting for the LCD
+    unsigned long updates;              // blocking Terminal and Screen updates
+    unsigned long update_bytes[t6963c_histogram_size]; // by bytes sent
+    unsigned long update_ns[t6963c_histogram_size];    // by time taken
+} T6963C_Stats;
+#endif
+
+/**
+ * A set of custom glyphs, and which of them are in CG RAM. A glyph is only
+ * uploaded when it is first shown. When all slots are taken, the least
+ * recently used glyph that is not on the LCD is replaced.
+ */
+typedef struct T6963C_Glyphs {
+    const unsigned char* bitmaps;       // 8 bytes per glyph, the top row first
+    unsigned short count;               // number of glyphs
+    unsigned short glyph[t6963c_cg_slots]; // glyph in each slot, 0xffff if none
+    unsigned long used[t6963c_cg_slots];   // when each slot was last used
+    unsigned long clock;                // number of uses so far
+    unsigned long render;               // clock at the start of the render
+    unsigned char pending[(t6963c_cg_slots + 7) / 8]; // slots to upload
+    unsigned char uploads;              // number of slots to upload
+    unsigned char upload_slot;          // slot that is being uploaded
+    unsigned char upload_row;           // next row of it
+    unsigned char visible[16];          // codes 0x80.. on the LCD or in frame
+    unsigned visible_known;             // whether visible is up to date
+} T6963C_Glyphs;
+
+/**
+ * An LCD and the state of the driver for it. Set it up with
+ * t6963c_display_setup(); the fields below the geometry are private.
+ */
+typedef struct T6963C_Display {
+    unsigned char rows, columns;        // size of the screen in characters
+    unsigned short text_rows;           // rows in the text RAM, see above
+    unsigned short graphic_home;        // start of the graphic area
+    unsigned char cg_offset;            // offset register, see above
+    T6963C_Bus bus;
+
+    char* shadow;                       // codes in the text RAM
+    char* shadow_attr;                  // the same, for the attributes
+    char* frame;                        // codes that should be displayed
+    char* frame_attr;                   // the same, for the attributes
+    unsigned short top;                 // RAM row at the top of the frame
+    unsigned short home;                // RAM row at the top of the LCD
+    unsigned short home_attr;           // the same, for the attributes
+    unsigned short address;             // address pointer of the LCD
+    unsigned char mode;                 // current mode set
+    unsigned auto_write;                // whether auto write mode is on
+    unsigned char cursor_row, cursor_column;
+    unsigned char frame_row, frame_column;
+    unsigned short sync_cell;           // cells before this are in sync
+    unsigned short write_end;           // cells before this are written with
+                                        // data writes, as planned
+    unsigned synced;                    // whether the LCD shows the frame
+    T6963C_Glyphs* glyphs;              // custom glyphs, or NULL
+
+    unsigned busy;                      // whether the LCD may still be busy
+    unsigned char ready_mask;           // status bits to wait for
+    unsigned long ready_at;             // timestamp at which it is ready
+
+    Screen* screen;                     // Screen that is in the frame
+    Terminal* terminal;                 // Terminal that is in the frame
+    unsigned long first;                // position of its first character
+    unsigned long end;                  // position after its last character
+    unsigned short end_cell;            // cell after its last character
+    unsigned long index[t6963c_rows + 1]; // line starts of terminal
+
+#ifdef t6963c_stats
+    T6963C_Stats stats;
+    unsigned long update_at;            // timestamp at the start of an update
+    unsigned long update_bytes;         // bytes sent before it
+#endif
+} T6963C_Display;
+
+/**
+ * A rectangle of a display that shows its own Terminal. Lines wrap at the
+ * width of the window, and the last rows lines of the Terminal are shown.
+ * Set it up with t6963c_window_setup().
+ */
+typedef struct T6963C_Window {
+    T6963C_Display* display;
+    unsigned char row, column;          // position of the top left cell
+    unsigned char rows, columns;        // size in characters
+    Terminal* terminal;
+    unsigned cursor;                    // whether the cursor is shown at the
+                                        // end of this window
+    unsigned stale;                     // whether terminal changed since the
+                                        // window was rendered
+    unsigned long index[t6963c_rows + 1]; // line starts of terminal
+} T6963C_Window;
+
+/**
+ * The number of chars a display needs for its shadows and frames
+ */
+#define t6963c_display_buffer_size(rows, columns, text_rows) \
+        (2 * ((rows) + (text_rows)) * (columns))
+
+/**
+ * The pin backend and the display the functions without display argument use
+ */
+extern const T6963C_Bus t6963c_pins;
+extern T6963C_Display t6963c_default;
+
+/**
+ * Wait for at least ns ns, for a time that is not known at compile time
+ */
+void t6963c_wait_ns(unsigned long ns);
+
+/**
+ * Set up a display. This does not talk to the LCD; see t6963c_display_init.
+ * The graphic area starts at the first multiple of 0x100 after the text RAM,
+ * and the CG RAM is placed after it as with t6963c_cg_offset.
+ * @param text_rows at least rows
+ * @param buffer room for t6963c_display_buffer_size(rows, columns, text_rows)
+ *   chars
+ */
+void t6963c_display_setup(T6963C_Display*, const T6963C_Bus* bus,
+        unsigned char rows, unsigned char columns, unsigned short text_rows,
+        char* buffer);
+
+/**
+ * Wait until the LCD has processed the last byte sent to it
+ */
+void t6963c_display_wait(T6963C_Display*);
+
+/**
+ * Check without waiting whether the LCD has processed the last byte sent to it
+ */
+unsigned t6963c_display_idle(T6963C_Display*);
+
+/*
+ * The functions below do the same as the functions without display_ in their
+ * name, which are documented further down, on a given display.
+ */
+unsigned char t6963c_display_readStatus(T6963C_Display*);
+void t6963c_display_writeByte(T6963C_Display*, unsigned cd, char byte);
+void t6963c_display_sendCmd(T6963C_Display*, char cmd, unsigned char n,
+        char data1, char data2);
+void t6963c_display_sendAuto(T6963C_Display*, char byte);
+unsigned t6963c_display_ready(T6963C_Display*);
+void t6963c_display_writeCmd0(T6963C_Display*, char cmd);
+void t6963c_display_writeCmd1(T6963C_Display*, char cmd, char data);
+void t6963c_display_writeCmd2(T6963C_Display*, char cmd, char data1,
+        char data2);
+void t6963c_display_startAutoWrite(T6963C_Display*);
+void t6963c_display_stopAutoWrite(T6963C_Display*);
+void t6963c_display_autoWrite(T6963C_Display*, char byte);
+void t6963c_display_autoWriteRun(T6963C_Display*, const char* bytes,
+        unsigned short n);
+void t6963c_display_autoWriteChar(T6963C_Display*, char character);
+void t6963c_display_writeString(T6963C_Display*, char* string);
+void t6963c_display_clear(T6963C_Display*);
+void t6963c_display_init(T6963C_Display*);
+void t6963c_display_set_mode(T6963C_Display*, unsigned char mode);
+unsigned short t6963c_display_get_address(T6963C_Display*);
+void t6963c_display_show_page(T6963C_Display*, unsigned char page);
+unsigned char t6963c_display_page(T6963C_Display*);
+void t6963c_display_set_address(T6963C_Display*, unsigned char row,
+        unsigned char column);
+void t6963c_display_set_cursor_address(T6963C_Display*, unsigned char row,
+        unsigned char column);
+void t6963c_display_render_terminal(T6963C_Display*, Terminal*);
+unsigned long t6963c_display_sync_step(T6963C_Display*);
+void t6963c_display_update_terminal(T6963C_Display*, Terminal*);
+void t6963c_display_render_screen(T6963C_Display*, Screen*);
+void t6963c_display_update_screen(T6963C_Display*, Screen*);
+void t6963c_display_set_glyphs(T6963C_Display*, T6963C_Glyphs*,
+        const unsigned char* bitmaps, unsigned short count);
+unsigned char t6963c_display_glyph(T6963C_Display*, unsigned short glyph);
+#ifdef t6963c_stats
+void t6963c_display_get_stats(T6963C_Display*, T6963C_Stats*);
+void t6963c_display_reset_stats(T6963C_Display*);
+#endif
+
+/**
+ * Read the status byte of the LCD
+ */
+unsigned char t6963c_readStatus(void);
+
+/**
+ * Write a single byte to the LCD, after waiting for the previous one
  * @param cd whether this is a command (1) or data (0)
  * @param byte the byte to send
  */
 void t6963c_writeByte(unsigned cd, char byte);
 
+/**
+ * Send a command with n (0, 1 or 2) data bytes to the LCD, without waiting for
+ * it to be processed.
+ */
+void t6963c_sendCmd(char cmd, unsigned char n, char data1, char data2);
+
+/**
+ * Send an auto write byte to the LCD, without waiting for it to be processed.
+ */
+void t6963c_sendAuto(char byte);
+
+/**
+ * Check the status of the LCD, to see whether it is ready for the next byte.
+ * In auto write mode STA3 is checked, otherwise STA0 and STA1.
+ */
+unsigned t6963c_ready(void);
+
+/**
+ * Write a command without data bytes to the LCD
+ * @param cmd the command byte
+ */
+void t6963c_writeCmd0(char cmd);
+
 /**
  * Write a command with one data byte to the LCD
  * @param cmd the command byte
@@ -140,7 +522,15 @@ void t6963c_stopAutoWrite(void);
 void t6963c_autoWrite(char byte);
 
 /**
- * Auto write an ASCII byte to the LCD
+ * Auto write n raw bytes to the LCD. With a bus backend that writes runs, this
+ * is done in one call to it.
+ * @see t6963c_startAutoWrite
+ */
+void t6963c_autoWriteRun(const char* bytes, unsigned short n);
+
+/**
+ * Auto write an ASCII byte to the LCD. With custom glyphs, a byte from 0x80
+ * on shows a glyph if it is already in CG RAM, and a blank otherwise.
  * @param character the character
  * @see t6963c_startAutoWrite
  */
@@ -163,7 +553,32 @@ void t6963c_clear(void);
 void t6963c_init(void);
 
 /**
- * Set the data write address
+ * Set the mode. t6963c_init() sets text attribute mode; use one of the other
+ * modes to show graphics.
+ * @param mode t6963c_mode_or, t6963c_mode_exor, t6963c_mode_and or
+ *   t6963c_mode_attr
+ */
+void t6963c_set_mode(unsigned char mode);
+
+/**
+ * The address pointer of the LCD, as far as the library knows
+ */
+unsigned short t6963c_get_address(void);
+
+/**
+ * Show a page of pixels of the graphic area, with one graphic home address
+ * command. Page p starts p screens of pixels after the graphic home address.
+ * This is reset to page 0 by t6963c_clear() and t6963c_set_mode().
+ */
+void t6963c_show_page(unsigned char page);
+
+/**
+ * The page of pixels that is shown, see t6963c_show_page()
+ */
+unsigned char t6963c_page(void);
+
+/**
+ * Set the data write address, relative to the top of the screen
  * @param row
  * @param column
  */
@@ -176,11 +591,132 @@ void t6963c_set_address(unsigned char row, unsigned char column);
  */
 void t6963c_set_cursor_address(unsigned char row, unsigned char column);
 
+/**
+ * Render a Terminal into the frame: the text that should be displayed. This
+ * does not write to the LCD; see t6963c_sync_step.
+ */
+void t6963c_render_terminal(Terminal*);
+
+/**
+ * Do one step to bring the text RAM in sync with the frame: send a command,
+ * or one byte in auto write mode. This does not wait for the LCD.
+ * @return the time in ns to wait before the next step, or 0 if the LCD shows
+ *   the frame
+ */
+unsigned long t6963c_sync_step(void);
+
 /**
  * This function may be used as a callback from a Terminal.update.
+ * The driver keeps a shadow copy of the text RAM, and only the cells that
+ * differ from it are sent to the LCD. When the Terminal.change shows that
+ * characters were only appended, only those characters are rendered.
+ * In text attribute mode, the attributes of the characters (see
+ * terminal.use_attributes) are kept in sync in the same pass, so that changing
+ * an attribute only writes the cells it applies to.
  */
 void t6963c_update_terminal(Terminal*);
 
+/**
+ * Use custom glyphs. Afterwards, the characters 0x80 to 0xff in strings and
+ * Terminals show glyphs 0 to 127. They are uploaded to CG RAM when they are
+ * first shown, by t6963c_writeString and t6963c_update_terminal. When all
+ * slots are in use on the LCD, a glyph is shown as a blank.
+ * @param glyphs the cache, which should live as long as it is used
+ * @param bitmaps 8 bytes per glyph, the top row first and the leftmost pixel
+ *   in bit 7. With a 6 pixel wide font, only the lowest 6 bits are shown.
+ * @param count the number of glyphs, or 0 to stop using custom glyphs
+ */
+void t6963c_set_glyphs(T6963C_Glyphs* glyphs, const unsigned char* bitmaps,
+        unsigned short count);
+
+/**
+ * Get the code that shows a custom glyph, and upload the glyph if needed.
+ * This also works for glyphs from 128 on, which cannot be put in a string.
+ * The LCD should not be in auto write mode.
+ * @return the code, or 0 (a blank) if there is no free slot
+ */
+unsigned char t6963c_glyph(unsigned short glyph);
+
+/**
+ * Render the cells of a Screen that changed into the frame. The first time a
+ * Screen is rendered, all cells are. Only the part of the Screen that fits on
+ * the LCD is shown. Attributes are mapped to text attributes: reverse to
+ * t6963c_attr_invert, hidden to t6963c_attr_inhibit and blink to
+ * t6963c_attr_blink; bold and underline are not shown.
+ */
+void t6963c_render_screen(Screen*);
+
+/**
+ * This function may be used as a callback from a Screen.update. Only the cells
+ * that changed are rendered, and of those only the ones that differ from the
+ * LCD are written.
+ */
+void t6963c_update_screen(Screen*);
+
+/**
+ * Like t6963c_update_screen, for the display in Screen.data
+ */
+void t6963c_update_screen_display(Screen*);
+
+/**
+ * Like t6963c_update_terminal, for the display in Terminal.data
+ */
+void t6963c_update_terminal_display(Terminal*);
+
+/**
+ * Update n displays, each with its own Terminal. The displays are written in
+ * turns: while one is busy with a command, the others are written.
+ */
+void t6963c_update_terminals(T6963C_Display* const* displays,
+        Terminal* const* terms, unsigned char n);
+
+/**
+ * Set up a window on a display, showing a Terminal. This sets Terminal.data to
+ * the window, for t6963c_update_window and t6963c_mark_window. Windows should
+ * not overlap, and should not be mixed with t6963c_update_terminal or
+ * t6963c_update_screen on the same display.
+ */
+void t6963c_window_setup(T6963C_Window*, T6963C_Display*, unsigned char row,
+        unsigned char column, unsigned char rows, unsigned char columns,
+        Terminal*);
+
+/**
+ * Render the Terminal of a window into the frame of its display. Only the
+ * cells of the window change, and only those are compared when the display is
+ * brought in sync.
+ */
+void t6963c_render_window(T6963C_Window*);
+
+/**
+ * Render the window in Terminal.data and write its changed cells to the LCD.
+ * May be used as a callback from a Terminal.update.
+ */
+void t6963c_update_window(Terminal*);
+
+/**
+ * Mark the window in Terminal.data stale, for t6963c_compose. May be used as a
+ * callback from a Terminal.update.
+ */
+void t6963c_mark_window(Terminal*);
+
+/**
+ * Render the stale windows of n windows, and write their changes to the LCDs.
+ * Windows that did not change are not touched.
+ */
+void t6963c_compose(T6963C_Window* const* windows, unsigned char n);
+
+#ifdef t6963c_stats
+/**
+ * Copy the counters of the display, as they are now
+ */
+void t6963c_get_stats(T6963C_Stats*);
+
+/**
+ * Set all counters of the display to zero
+ */
+void t6963c_reset_stats(void);
+#endif
+
 #ifdef	__cplusplus
 }
 #endif
@@ -0,0 +1,576 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_bench.c
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Benchmarks for the driver and the Terminal, run against the simulated
+ * controller. Every workload is run twice: once with the display attached, to
+ * measure the bus, and once without, to measure the CPU time of the Terminal
+ * bookkeeping. Results are printed as one JSON object per line:
+ *
+ *     {"workload":"typing","terminal":"ring","ops":200,"bytes":...,...}
+ *
+ * Every workload runs on a circular Terminal of 4096 characters ("ring") and
+ * on one from terminal.construct that grows when it is full ("grow").
+ *
+ * bytes, commands and reads count bytes on the bus, bus_ns is the simulated
+ * time and delay_ns the part of it spent in delays. violations counts bytes
+ * written while the controller was busy, and timing pin changes that came
+ * sooner than the datasheet allows. terminal_cpu_ns is the host CPU time of
+ * the workload without display.
+ *
+ * The two_displays workloads drive a second simulated controller next to
+ * t6963c_sim, through a T6963C_Bus; its violations are counted as well. The
+ * block workloads repeat others through a T6963C_Bus that writes commands and
+ * auto write runs at once.
+ *
+ * With -t, the bus of every workload with display is recorded with
+ * t6963c_trace.h into <workload>.trace, or <workload>.grow.trace for a growing
+ * Terminal, to be replayed with t6963c_replay.c.
+ *
+ * Usage: t6963c_bench [-t] [workload...]
+ */
+
+#include "t6963c.h"
+#include "t6963c_queue.h"
+#include "t6963c_graphics.h"
+#include "t6963c_refresh.h"
+#include "t6963c_trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    const char* name;
+    unsigned int ops;               // number of operations in the workload
+    void (*run)(Terminal*, unsigned int ops);
+    void (*update)(Terminal*);      // NULL for t6963c_update_terminal
+} Workload;
+
+static unsigned bench_record;           // whether to record traces
+static T6963C_Trace* bench_trace;       // the current recording, or NULL
+
+/**
+ * The simulated time in ticks. Unlike t6963c_timestamp(), reading it does not
+ * advance the time, so recording does not change the results.
+ */
+static unsigned long bench_trace_clock(void) {
+    return t6963c_sim_ns / t6963c_nspertick;
+}
+
+static const char* t6963c_bench_words[] = {
+    "sensor", "ok", "temperature", "21.5C", "pressure", "1013hPa", "link",
+    "up", "retry", "timeout", "battery", "87%"
+};
+
+/**
+ * Append a log line of a pseudo-random length to a Terminal
+ */
+static void bench_log_line(Terminal* term, unsigned int i) {
+    char line[64];
+    unsigned int j, n = 2 + (i * 7) % 5;
+    sprintf(line, "\n%05u", i);
+    for (j = 0; j < n; j++) {
+        strcat(line, " ");
+        strcat(line, t6963c_bench_words[(i + j * 5) % 12]);
+    }
+    terminal.append(term, line);
+}
+
+static void bench_log_stream(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    for (i = 0; i < ops; i++)
+        bench_log_line(term, i);
+}
+
+/**
+ * The lines of bench_log_stream, written directly into the Terminal by
+ * terminal.format
+ */
+static void bench_formatted_log(Terminal* term, unsigned int ops) {
+    unsigned int i, j, n;
+    for (i = 0; i < ops; i++) {
+        n = 2 + (i * 7) % 5;
+        terminal.begin(term);
+        terminal.format(term, "\n%05u", i);
+        for (j = 0; j < n; j++)
+            terminal.format(term, " %s", t6963c_bench_words[(i + j * 5) % 12]);
+        terminal.end(term);
+    }
+}
+
+static unsigned long bench_app_us;      // time the application spent
+
+/**
+ * The clock of rate_limited: the time on the bus and in the application, in us
+ */
+static unsigned long bench_clock(void) {
+    return (unsigned long) (t6963c_sim_ns / 1000) + bench_app_us;
+}
+
+/**
+ * The lines of bench_log_stream, one every 2 ms, shown by a refresh of at most
+ * 25 updates per second
+ */
+static void bench_rate_limited(Terminal* term, unsigned int ops) {
+    static T6963C_Refresh refresh;
+    unsigned int i;
+
+    if (term->update) {
+        t6963c_refresh_setup(&refresh, &t6963c_default, bench_clock, 40000,
+                100000);
+        term->update = t6963c_update_terminal_scheduled;
+        term->data = &refresh;
+    }
+    for (i = 0; i < ops; i++) {
+        bench_app_us += 2000;
+        bench_log_line(term, i);
+        if (term->update)
+            t6963c_refresh_tick(&refresh);
+    }
+    if (term->update)
+        t6963c_refresh_flush(&refresh);
+}
+
+static void bench_typing(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    for (i = 0; i < ops; i++)
+        terminal.appendChar(term, i % 31 == 30 ? '\n' : 'a' + i % 26);
+}
+
+static void bench_batched_lines(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    for (i = 0; i < ops; i++) {
+        if (i % 30 == 0) {
+            if (i)
+                terminal.end(term);
+            terminal.begin(term);
+            terminal.appendChar(term, '\n');
+        }
+        terminal.appendChar(term, 'a' + i % 26);
+    }
+    terminal.end(term);
+}
+
+/**
+ * Run the write queue for some time, with a tick every 5us
+ */
+static void bench_ticks(unsigned int ticks) {
+    for (; ticks && t6963c_queue_depth(); ticks--) {
+        t6963c_sim_ns += 5000;
+        t6963c_queue_tick(5000);
+    }
+}
+
+static void bench_queued_typing(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    for (i = 0; i < ops; i++) {
+        terminal.appendChar(term, i % 31 == 30 ? '\n' : 'a' + i % 26);
+        bench_ticks(20);
+    }
+    bench_ticks(-1);
+}
+
+static void bench_full_redraw(Terminal* term, unsigned int ops) {
+    char screen[t6963c_rows * t6963c_columns + 1];
+    unsigned int i, j;
+    for (i = 0; i < ops; i++) {
+        for (j = 0; j < t6963c_rows * t6963c_columns; j++)
+            screen[j] = 'A' + (i + j) % 26;
+        screen[j - 1] = '\0';
+        terminal.discard(term, terminal.size(term));
+        terminal.append(term, screen);
+    }
+}
+
+static void bench_scroll_burst(Terminal* term, unsigned int ops) {
+    char burst[8 * 24 + 1];
+    unsigned int i, j;
+    for (i = 0; i < ops; i++) {
+        burst[0] = '\0';
+        for (j = 0; j < 8; j++)
+            sprintf(burst + strlen(burst), "\nburst %03u line %u", i, j);
+        terminal.append(term, burst);
+    }
+}
+
+static void bench_clear(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    for (i = 0; i < ops; i++)
+        if (term->update)
+            t6963c_clear();
+}
+
+/**
+ * Plot a scrolling chart: every operation moves a marker and adds a segment
+ */
+static void bench_graphics(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    int x, y, last = t6963c_height / 2;
+    if (!term->update)
+        return;
+    t6963c_graphics_init();
+    t6963c_rect(0, 0, t6963c_width, t6963c_height, 1);
+    for (i = 0; i < ops; i++) {
+        x = 2 + i % (t6963c_width - 4);
+        y = 4 + (i * 37) % (t6963c_height - 8);
+        t6963c_fill(x, 1, 1, t6963c_height - 2, 0);
+        t6963c_line(x - 1, last, x, y, 1);
+        last = y;
+        t6963c_graphics_flush();
+    }
+}
+
+/**
+ * Scroll a line of text through the screen one pixel at a time. Without a
+ * display only the drawing is done, to measure its CPU time.
+ */
+static void bench_glyphs(Terminal* term, unsigned int ops) {
+    static unsigned char glyphs[96 * 8];
+    static unsigned short cache[t6963c_font_cache_size(96)];
+    T6963C_Font font;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(glyphs); i++)
+        glyphs[i] = i * 37 + (i >> 3);
+    t6963c_font_init(&font, glyphs, 0x20, 96, cache);
+    if (term->update)
+        t6963c_graphics_init();
+    for (i = 0; i < ops; i++) {
+        t6963c_fill(0, 60, t6963c_width, 8, 0);
+        t6963c_text(t6963c_width - i % t6963c_width, 60, &font,
+                "The quick brown fox jumps over the lazy dog", t6963c_rop_or);
+        t6963c_text(i % t6963c_width, 20 + i % 30, &font, "sensor 21.5C",
+                t6963c_rop_xor);
+        if (term->update)
+            t6963c_graphics_flush();
+    }
+}
+
+/**
+ * Update a status line and a progress bar in place with escape sequences,
+ * as a serial console would, while a log scrolls below them
+ */
+static void bench_vt_status(Terminal* term, unsigned int ops) {
+    Screen* scr = screen.construct(t6963c_rows, t6963c_columns);
+    char line[96];
+    unsigned int i;
+
+    scr->update = term->update ? t6963c_update_screen : NULL;
+    screen.print(scr, "\x1b[2J");
+    for (i = 0; i < ops; i++) {
+        sprintf(line, "\x1b" "7\x1b[1;1H\x1b[7m temp %3u.%uC \x1b[0m "
+                "\x1b[2;1H[%-*.*s]\x1b" "8", 20 + i % 10, i % 10, 
+                30, (i * 30 / ops) % 31,
+                "##############################");
+        screen.print(scr, line);
+        if (i % 10 == 9) {
+            sprintf(line, "\x1b[16;1H\n%05u %s", i,
+                    t6963c_bench_words[i % 12]);
+            screen.print(scr, line);
+        }
+    }
+    screen.free(scr);
+}
+
+/**
+ * Move a highlight over the words of a screen of text
+ */
+static void bench_highlight(Terminal* term, unsigned int ops) {
+    unsigned int i;
+    terminal.use_attributes(term);
+    for (i = 0; i < t6963c_rows - 1; i++)
+        bench_log_line(term, i);
+    for (i = 0; i < ops; i++) {
+        terminal.begin(term);
+        terminal.change_attributes(term, 0, terminal.size(term),
+                t6963c_attr_normal);
+        terminal.change_attributes(term, (i * 13) % terminal.size(term), 6,
+                i % 2 ? t6963c_attr_invert : t6963c_attr_blink);
+        terminal.end(term);
+    }
+}
+
+/**
+ * A log with a status icon on every line, from a set of 16 custom glyphs
+ */
+static void bench_icons(Terminal* term, unsigned int ops) {
+    static unsigned char bitmaps[16 * 8];
+    static T6963C_Glyphs glyphs;
+    char icon[3] = " ";
+    unsigned int i;
+
+    for (i = 0; i < sizeof(bitmaps); i++)
+        bitmaps[i] = i * 37 + (i >> 3);
+    t6963c_set_glyphs(&glyphs, bitmaps, 16);
+    for (i = 0; i < ops; i++) {
+        bench_log_line(term, i);
+        icon[1] = 0x80 + (i * 7) % 16;
+        terminal.append(term, icon);
+    }
+    t6963c_set_glyphs(NULL, NULL, 0);
+}
+
+/**
+ * Stream a log to two displays: the default one and one on a second simulated
+ * controller. With interleave, the displays are written in turns.
+ */
+static void bench_two(Terminal* term, unsigned int ops, unsigned interleave) {
+    static T6963C_Sim sim;
+    static char buffer[t6963c_display_buffer_size(
+            t6963c_rows, t6963c_columns, t6963c_rows)];
+    static const T6963C_Bus bus = {t6963c_sim_bus_write, t6963c_sim_bus_status,
+            t6963c_sim_bus_reset, &sim, NULL, NULL};
+    T6963C_Display display;
+    T6963C_Display* displays[2];
+    Terminal* terms[2];
+    unsigned int i;
+
+    if (!term->update)
+        return;
+    t6963c_sim_init(&sim);
+    t6963c_display_setup(&display, &bus, t6963c_rows, t6963c_columns,
+            t6963c_rows, buffer);
+    t6963c_display_init(&display);
+    displays[0] = &t6963c_default;
+    displays[1] = &display;
+    terms[0] = term;
+    terms[1] = terminal.construct_ring(4096);
+    term->update = NULL;
+    for (i = 0; i < ops; i++) {
+        bench_log_line(terms[0], i);
+        bench_log_line(terms[1], ops - i);
+        if (interleave) {
+            t6963c_update_terminals(displays, terms, 2);
+        } else {
+            t6963c_display_update_terminal(displays[0], terms[0]);
+            t6963c_display_update_terminal(displays[1], terms[1]);
+        }
+    }
+    t6963c_display_wait(&display);
+    terminal.free(terms[1]);
+    t6963c_sim.violations += sim.violations;
+    t6963c_sim.timing += sim.timing;
+}
+
+static void bench_two_displays(Terminal* term, unsigned int ops) {
+    bench_two(term, ops, 1);
+}
+
+static void bench_two_displays_serial(Terminal* term, unsigned int ops) {
+    bench_two(term, ops, 0);
+}
+
+/**
+ * Run a workload with the block functions of the simulated bus, as with a
+ * parallel master port or DMA, instead of the pins
+ */
+static void bench_block(Terminal* term, unsigned int ops,
+        void (*run)(Terminal*, unsigned int)) {
+    static const T6963C_Bus bus = {t6963c_sim_bus_write, t6963c_sim_bus_status,
+            t6963c_sim_bus_reset, &t6963c_sim, t6963c_sim_bus_command,
+            t6963c_sim_bus_run};
+    T6963C_Bus display = t6963c_default.bus;
+    // When recording, the block bus is put behind the trace
+    T6963C_Bus* target = bench_trace ? &bench_trace->target : 
+            &t6963c_default.bus;
+    T6963C_Bus pins = *target;
+    *target = bus;
+    if (bench_trace) {
+        t6963c_default.bus.command = t6963c_trace_command;
+        t6963c_default.bus.run = t6963c_trace_run;
+    }
+    run(term, ops);
+    t6963c_display_wait(&t6963c_default);
+    *target = pins;
+    t6963c_default.bus = display;
+}
+
+static void bench_block_log_stream(Terminal* term, unsigned int ops) {
+    bench_block(term, ops, bench_log_stream);
+}
+
+static void bench_block_full_redraw(Terminal* term, unsigned int ops) {
+    bench_block(term, ops, bench_full_redraw);
+}
+
+static void bench_block_graphics(Terminal* term, unsigned int ops) {
+    bench_block(term, ops, bench_graphics);
+}
+
+/**
+ * A status bar, a log pane and an alarm pane, each with its own Terminal. The
+ * log gets a line every operation, the status bar every 10 and the alarm pane
+ * every 50.
+ */
+static void bench_windows(Terminal* term, unsigned int ops) {
+    static T6963C_Window windows[3];
+    Terminal* terms[3];
+    unsigned int i;
+
+    terms[0] = terminal.construct_ring(256);
+    terms[1] = term;
+    terms[2] = terminal.construct_ring(256);
+    if (term->update) {
+        t6963c_window_setup(&windows[0], &t6963c_default, 0, 0, 1,
+                t6963c_columns, terms[0]);
+        t6963c_window_setup(&windows[1], &t6963c_default, 1, 0, 
+                t6963c_rows - 4, t6963c_columns, terms[1]);
+        t6963c_window_setup(&windows[2], &t6963c_default, t6963c_rows - 3, 0,
+                3, t6963c_columns, terms[2]);
+        for (i = 0; i < 3; i++)
+            terms[i]->update = t6963c_update_window;
+    }
+    for (i = 0; i < ops; i++) {
+        bench_log_line(terms[1], i);
+        if (i % 10 == 0)
+            terminal.format(terms[0], "\nlines: %u", i);
+        if (i % 50 == 0)
+            terminal.format(terms[2], "\nalarm %u: %s", i / 50,
+                    t6963c_bench_words[i % 12]);
+    }
+    terminal.free(terms[0]);
+    terminal.free(terms[2]);
+}
+
+static const Workload t6963c_bench_workloads[] = {
+    {"log_stream", 200, bench_log_stream, NULL},
+    {"formatted_log", 200, bench_formatted_log, NULL},
+    {"rate_limited", 200, bench_rate_limited, NULL},
+    {"typing", 200, bench_typing, NULL},
+    {"batched_lines", 300, bench_batched_lines, NULL},
+    {"queued_typing", 200, bench_queued_typing, t6963c_update_terminal_async},
+    {"full_redraw", 10, bench_full_redraw, NULL},
+    {"scroll_burst", 20, bench_scroll_burst, NULL},
+    {"clear", 10, bench_clear, NULL},
+    {"graphics", 100, bench_graphics, NULL},
+    {"glyphs", 200, bench_glyphs, NULL},
+    {"vt_status", 200, bench_vt_status, NULL},
+    {"highlight", 200, bench_highlight, NULL},
+    {"icons", 200, bench_icons, NULL},
+    {"two_displays", 100, bench_two_displays, NULL},
+    {"two_displays_serial", 100, bench_two_displays_serial, NULL},
+    {"windows", 200, bench_windows, NULL},
+    {"block_log_stream", 200, bench_block_log_stream, NULL},
+    {"block_full_redraw", 10, bench_block_full_redraw, NULL},
+    {"block_graphics", 100, bench_block_graphics, NULL},
+};
+
+static unsigned long long bench_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * The kinds of Terminal that every workload runs on
+ */
+static const char* bench_kinds[] = {"ring", "grow"};
+
+static Terminal* bench_construct(unsigned int kind) {
+    return kind ? terminal.construct(4096) : terminal.construct_ring(4096);
+}
+
+static void bench_run(const Workload* workload, unsigned int kind) {
+    Terminal* term;
+    unsigned long writes, commands, reads, violations, timing;
+    unsigned long long ns, delay_ns, cpu_ns;
+    static unsigned char buffer[1 << 22];
+    T6963C_Trace trace;
+    T6963C_Bus pins = t6963c_default.bus;
+    char name[64];
+    FILE* file;
+
+    t6963c_sim_init(&t6963c_sim);
+    if (bench_record) {
+        bench_trace = &trace;
+        t6963c_trace_setup(&trace, &pins, buffer, sizeof(buffer),
+                bench_trace_clock);
+        t6963c_default.bus = trace.bus;
+    }
+    t6963c_init();
+
+    term = bench_construct(kind);
+    term->update = workload->update ? workload->update : t6963c_update_terminal;
+    writes = t6963c_sim.writes;
+    commands = t6963c_sim.commands;
+    reads = t6963c_sim.reads;
+    violations = t6963c_sim.violations;
+    timing = t6963c_sim.timing;
+    ns = t6963c_sim_ns;
+    delay_ns = t6963c_sim_delay_ns;
+    workload->run(term, workload->ops);
+    terminal.free(term);
+
+    if (bench_trace) {
+        t6963c_default.bus = pins;
+        snprintf(name, sizeof(name), kind ? "%s.%s.trace" : "%s.trace",
+                workload->name, bench_kinds[kind]);
+        if ((file = fopen(name, "wb"))) {
+            fwrite(trace.buffer, 1, trace.length, file);
+            fclose(file);
+        } else {
+            perror(name);
+        }
+        if (trace.dropped)
+            fprintf(stderr, "%s: %lu events dropped\n", name, trace.dropped);
+        bench_trace = NULL;
+    }
+
+    term = bench_construct(kind);
+    cpu_ns = bench_cpu_ns();
+    workload->run(term, workload->ops);
+    cpu_ns = bench_cpu_ns() - cpu_ns;
+    terminal.free(term);
+
+    printf("{\"workload\":\"%s\",\"terminal\":\"%s\",\"ops\":%u,"
+            "\"bytes\":%lu,\"commands\":%lu,"
+            "\"reads\":%lu,\"bus_ns\":%llu,\"delay_ns\":%llu,"
+            "\"violations\":%lu,\"timing\":%lu,\"terminal_cpu_ns\":%llu}\n",
+            workload->name, bench_kinds[kind], workload->ops,
+            t6963c_sim.writes - writes, t6963c_sim.commands - commands,
+            t6963c_sim.reads - reads, t6963c_sim_ns - ns,
+            t6963c_sim_delay_ns - delay_ns,
+            t6963c_sim.violations - violations, t6963c_sim.timing - timing,
+            cpu_ns);
+}
+
+int main(int argc, char** argv) {
+    unsigned int i, kind;
+    int j, first = 1;
+    if (argc > 1 && !strcmp(argv[1], "-t")) {
+        bench_record = 1;
+        first = 2;
+    }
+    for (i = 0; i < sizeof(t6963c_bench_workloads) / sizeof(Workload); i++) {
+        if (argc > first) {
+            for (j = first; j < argc; j++)
+                if (!strcmp(argv[j], t6963c_bench_workloads[i].name))
+                    break;
+            if (j == argc)
+                continue;
+        }
+        for (kind = 0; kind < sizeof(bench_kinds) / sizeof(bench_kinds[0]);
+                kind++)
+            bench_run(&t6963c_bench_workloads[i], kind);
+    }
+    return 0;
+}
@@ -0,0 +1,435 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_graphics.h"
+#include "t6963c_plan.h"
+#include <string.h>
+
+static unsigned char t6963c_pixels[t6963c_height * t6963c_columns];
+
+// Per pixel row, the bytes from .. to (exclusive) may differ from the LCD
+static unsigned char t6963c_dirty_from[t6963c_height];
+static unsigned char t6963c_dirty_to[t6963c_height];
+// When this is a single byte, the bits that may have changed (0 if unknown)
+static unsigned char t6963c_dirty_bits[t6963c_height];
+
+#if t6963c_graphic_pages > 1
+// The same for the last frame, which the page that is not shown lacks
+static unsigned char t6963c_last_from[t6963c_height];
+static unsigned char t6963c_last_to[t6963c_height];
+static unsigned char t6963c_last_bits[t6963c_height];
+#endif
+
+/**
+ * Remember that bytes from .. to (exclusive) of a pixel row have changed
+ * @param bits for a single byte, the bits that have changed (0 if unknown)
+ */
+static void t6963c_mark(int y, unsigned char from, unsigned char to,
+        unsigned char bits) {
+    if (t6963c_dirty_from[y] >= t6963c_dirty_to[y]) {
+        t6963c_dirty_from[y] = from;
+        t6963c_dirty_to[y] = to;
+        t6963c_dirty_bits[y] = bits;
+        return;
+    }
+    if (from < t6963c_dirty_from[y])
+        t6963c_dirty_from[y] = from;
+    if (to > t6963c_dirty_to[y])
+        t6963c_dirty_to[y] = to;
+    if (t6963c_dirty_bits[y])
+        t6963c_dirty_bits[y] = bits ? t6963c_dirty_bits[y] | bits : 0;
+}
+
+/**
+ * Set or clear the bits in mask of a byte
+ */
+static inline void t6963c_put(unsigned char* byte, unsigned char mask,
+        unsigned on) {
+    if (on)
+        *byte |= mask;
+    else
+        *byte &= ~mask;
+}
+
+/**
+ * Set or clear the pixels x0 .. x1 (exclusive) of a pixel row. These should
+ * be on the screen, and x0 < x1.
+ */
+static void t6963c_span(int y, int x0, int x1, unsigned on) {
+    unsigned char* row = t6963c_pixels + y * t6963c_columns;
+    unsigned char first = x0 / 8, last = (x1 - 1) / 8, i;
+    unsigned char first_mask = 0xff >> (x0 % 8);
+    unsigned char last_mask = 0xff << (7 - (x1 - 1) % 8);
+
+    if (first == last) {
+        t6963c_put(row + first, first_mask & last_mask, on);
+    } else {
+        t6963c_put(row + first, first_mask, on);
+        for (i = first + 1; i < last; i++)
+            row[i] = on ? 0xff : 0x00;
+        t6963c_put(row + last, last_mask, on);
+    }
+    t6963c_mark(y, first, last + 1, 0);
+}
+
+void t6963c_graphics_init(void) {
+#if t6963c_graphic_pages > 1
+    unsigned short y;
+    for (y = 0; y < t6963c_height; y++) {
+        t6963c_last_from[y] = 0;
+        t6963c_last_to[y] = t6963c_columns;
+        t6963c_last_bits[y] = 0;
+    }
+#endif
+    t6963c_set_mode(t6963c_mode_or);
+    t6963c_graphics_clear();
+    t6963c_graphics_flush();
+}
+
+void t6963c_graphics_clear(void) {
+    unsigned short i;
+    for (i = 0; i < t6963c_height * t6963c_columns; i++)
+        t6963c_pixels[i] = 0x00;
+    for (i = 0; i < t6963c_height; i++) {
+        t6963c_dirty_from[i] = 0;
+        t6963c_dirty_to[i] = t6963c_columns;
+    }
+}
+
+void t6963c_graphics_flush(void) {
+    T6963C_Span spans[t6963c_plan_size];
+    T6963C_Plan plan;
+    unsigned short y, base = t6963c_graphic_home;
+    unsigned char n = 0, from, to, bits;
+#if t6963c_graphic_pages > 1
+    unsigned char page = !t6963c_page();
+    // Without changes the pages are the same, and need not be flipped
+    for (y = 0; y < t6963c_height && 
+            t6963c_dirty_from[y] >= t6963c_dirty_to[y]; y++);
+    if (y == t6963c_height)
+        return;
+    base += page * t6963c_height * t6963c_columns;
+#endif
+
+    for (y = 0; y < t6963c_height; y++) {
+        from = t6963c_dirty_from[y];
+        to = t6963c_dirty_to[y];
+        bits = t6963c_dirty_bits[y];
+#if t6963c_graphic_pages > 1
+        // The page also lacks the changes of the last frame
+        if (t6963c_last_from[y] >= t6963c_last_to[y]) {
+            // nothing to add
+        } else if (from >= to) {
+            from = t6963c_last_from[y];
+            to = t6963c_last_to[y];
+            bits = t6963c_last_bits[y];
+        } else {
+            if (from != t6963c_last_from[y] || to != t6963c_last_to[y] ||
+                    !bits || !t6963c_last_bits[y])
+                bits = 0;
+            else
+                bits |= t6963c_last_bits[y];
+            if (t6963c_last_from[y] < from)
+                from = t6963c_last_from[y];
+            if (t6963c_last_to[y] > to)
+                to = t6963c_last_to[y];
+        }
+        t6963c_last_from[y] = t6963c_dirty_from[y];
+        t6963c_last_to[y] = t6963c_dirty_to[y];
+        t6963c_last_bits[y] = t6963c_dirty_bits[y];
+#endif
+        if (from >= to)
+            continue;
+        spans[n].address = base + y * t6963c_columns + from;
+        spans[n].length = to - from;
+        spans[n].bits = spans[n].length == 1 ? bits : 0;
+        t6963c_dirty_from[y] = t6963c_columns;
+        t6963c_dirty_to[y] = 0;
+        if (++n == t6963c_plan_size) {
+            t6963c_plan(&plan, spans, n, t6963c_get_address());
+            t6963c_plan_run(&plan, t6963c_pixels, base);
+            n = 0;
+        }
+    }
+    if (n) {
+        t6963c_plan(&plan, spans, n, t6963c_get_address());
+        t6963c_plan_run(&plan, t6963c_pixels, base);
+    }
+#if t6963c_graphic_pages > 1
+    t6963c_show_page(page);
+#endif
+}
+
+void t6963c_pixel(int x, int y, unsigned on) {
+    if (x < 0 || x >= t6963c_width || y < 0 || y >= t6963c_height)
+        return;
+    t6963c_put(t6963c_pixels + y * t6963c_columns + x / 8, 
+            0x80 >> (x % 8), on);
+    t6963c_mark(y, x / 8, x / 8 + 1, 0x80 >> (x % 8));
+}
+
+unsigned t6963c_get_pixel(int x, int y) {
+    if (x < 0 || x >= t6963c_width || y < 0 || y >= t6963c_height)
+        return 0;
+    return (t6963c_pixels[y * t6963c_columns + x / 8] >> (7 - x % 8)) & 1;
+}
+
+void t6963c_line(int x0, int y0, int x1, int y1, unsigned on) {
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1, sx = x1 > x0 ? 1 : -1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0, sy = y1 > y0 ? 1 : -1;
+    int error = dx + dy, e2;
+
+    if (y0 == y1) {
+        t6963c_fill(x0 < x1 ? x0 : x1, y0, dx + 1, 1, on);
+        return;
+    }
+    for (;;) {
+        t6963c_pixel(x0, y0, on);
+        if (x0 == x1 && y0 == y1)
+            return;
+        e2 = 2 * error;
+        if (e2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void t6963c_rect(int x, int y, int w, int h, unsigned on) {
+    if (w <= 0 || h <= 0)
+        return;
+    t6963c_fill(x, y, w, 1, on);
+    t6963c_fill(x, y + h - 1, w, 1, on);
+    t6963c_fill(x, y + 1, 1, h - 2, on);
+    t6963c_fill(x + w - 1, y + 1, 1, h - 2, on);
+}
+
+void t6963c_fill(int x, int y, int w, int h, unsigned on) {
+    int x1 = x + w, y1 = y + h;
+    if (x < 0)
+        x = 0;
+    if (y < 0)
+        y = 0;
+    if (x1 > t6963c_width)
+        x1 = t6963c_width;
+    if (y1 > t6963c_height)
+        y1 = t6963c_height;
+    for (; x < x1 && y < y1; y++)
+        t6963c_span(y, x, x1, on);
+}
+
+/**
+ * Load a word from bytes, the first byte in the most significant bits
+ */
+static inline t6963c_word t6963c_load(const unsigned char* bytes) {
+    t6963c_word word = 0;
+    unsigned char i;
+    for (i = 0; i < sizeof(t6963c_word); i++)
+        word = (word << 8) | bytes[i];
+    return word;
+}
+
+/**
+ * Store a word as t6963c_load() reads it
+ */
+static inline void t6963c_store(unsigned char* bytes, t6963c_word word) {
+    unsigned char i;
+    for (i = sizeof(t6963c_word); i > 0; i--) {
+        bytes[i - 1] = word;
+        word >>= 8;
+    }
+}
+
+static inline t6963c_word t6963c_apply(t6963c_word dest, t6963c_word src,
+        unsigned char rop) {
+    switch (rop) {
+        case t6963c_rop_or:     return dest | src;
+        case t6963c_rop_andnot: return dest & ~src;
+        case t6963c_rop_xor:    return dest ^ src;
+        default:                return src;
+    }
+}
+
+/**
+ * Combine n bytes of src with dest. Only the bits in first_mask of the first
+ * byte and in last_mask of the last byte are changed; the bytes in between are
+ * done a word at a time. Since the raster operations work per bit, the byte
+ * order of the words does not matter here.
+ */
+static void t6963c_rop_bytes(unsigned char* dest, const unsigned char* src,
+        int n, unsigned char first_mask, unsigned char last_mask,
+        unsigned char rop) {
+    t6963c_word d, s;
+    int i;
+
+    if (n == 1)
+        first_mask &= last_mask;
+    dest[0] = (dest[0] & ~first_mask) |
+            (t6963c_apply(dest[0], src[0], rop) & first_mask);
+    if (n == 1)
+        return;
+    for (i = 1; i + (int) sizeof(t6963c_word) < n; i += sizeof(t6963c_word)) {
+        memcpy(&d, dest + i, sizeof(t6963c_word));
+        memcpy(&s, src + i, sizeof(t6963c_word));
+        d = t6963c_apply(d, s, rop);
+        memcpy(dest + i, &d, sizeof(t6963c_word));
+    }
+    for (; i < n - 1; i++)
+        dest[i] = t6963c_apply(dest[i], src[i], rop);
+    dest[i] = (dest[i] & ~last_mask) |
+            (t6963c_apply(dest[i], src[i], rop) & last_mask);
+}
+
+/**
+ * Combine a line of pixels with pixel row y. Byte i of the line goes to byte
+ * column + i of the row, but only pixels s .. s + w (exclusive) of the line
+ * are used. Parts outside of the screen are clipped.
+ */
+static void t6963c_blit_line(int y, int column, const unsigned char* line,
+        int s, int w, unsigned char rop) {
+    int first = 0, last = (s + w - 1) / 8;
+    unsigned char first_mask = 0xff >> s;
+    unsigned char last_mask = 0xff << (7 - (s + w - 1) % 8);
+
+    if (y < 0 || y >= t6963c_height || w <= 0)
+        return;
+    if (column < 0) {
+        first = -column;
+        first_mask = 0xff;
+    }
+    if (column + last >= t6963c_columns) {
+        last = t6963c_columns - 1 - column;
+        last_mask = 0xff;
+    }
+    if (first > last)
+        return;
+    t6963c_rop_bytes(t6963c_pixels + y * t6963c_columns + column + first,
+            line + first, last - first + 1, first_mask, last_mask, rop);
+    t6963c_mark(y, column + first, column + last + 1, 0);
+}
+
+/**
+ * Shift n bytes s (0 .. 7) pixels to the right into line, which gets n + 1
+ * bytes. This is done a word at a time.
+ */
+static void t6963c_shift(unsigned char* line, const unsigned char* src, int n,
+        unsigned char s) {
+    t6963c_word word, carry = 0;
+    int i;
+
+    if (s == 0) {
+        memcpy(line, src, n);
+        line[n] = 0x00;
+        return;
+    }
+    for (i = 0; i + (int) sizeof(t6963c_word) <= n; i += sizeof(t6963c_word)) {
+        word = t6963c_load(src + i);
+        t6963c_store(line + i, 
+                (carry << (8 * sizeof(t6963c_word) - s)) | (word >> s));
+        carry = word;
+    }
+    carry &= 0xff;
+    for (; i < n; i++) {
+        line[i] = (carry << (8 - s)) | (src[i] >> s);
+        carry = src[i];
+    }
+    line[n] = carry << (8 - s);
+}
+
+void t6963c_blit(int x, int y, const unsigned char* bitmap, int w, int h) {
+    t6963c_blit_rop(x, y, bitmap, w, h, t6963c_rop_copy);
+}
+
+void t6963c_blit_rop(int x, int y, const unsigned char* bitmap, int w, int h,
+        unsigned char rop) {
+    unsigned char line[t6963c_columns + 2];
+    int stride = (w + 7) / 8, s = x & 7, column = (x - s) / 8, skip = 0, row;
+
+    if (w <= 0 || x >= t6963c_width || x + w <= 0)
+        return;
+    // Only shift the part of the bitmap that is on the screen
+    if (column < 0) {
+        skip = -column - 1;
+        column = -1;
+    }
+    if (stride - skip > t6963c_columns + 1)
+        stride = skip + t6963c_columns + 1;
+    for (row = 0; row < h; row++) {
+        if (y + row < 0 || y + row >= t6963c_height)
+            continue;
+        t6963c_shift(line, bitmap + row * ((w + 7) / 8) + skip, stride - skip,
+                s);
+        t6963c_blit_line(y + row, column, line, s, w - 8 * skip, rop);
+    }
+}
+
+void t6963c_font_init(T6963C_Font* font, const unsigned char* glyphs,
+        unsigned char first, unsigned char count, unsigned short* cache) {
+    unsigned short glyph;
+    unsigned char s, row;
+    font->first = first;
+    font->count = count;
+    font->shifted = cache;
+    for (glyph = 0; glyph < count; glyph++)
+        for (s = 0; s < 8; s++)
+            for (row = 0; row < 8; row++)
+                *cache++ = (unsigned short) glyphs[glyph * 8 + row] << (8 - s);
+}
+
+void t6963c_text(int x, int y, const T6963C_Font* font, const char* string,
+        unsigned char rop) {
+    unsigned char line[t6963c_columns + 2];
+    const unsigned short* shifted[t6963c_columns + 1];
+    int s = x & 7, column = (x - s) / 8, n, i, length = strlen(string);
+    unsigned short bits;
+    unsigned char c, row;
+
+    // Only glyphs that are (partly) on the screen are drawn
+    if (column < -1) {
+        i = -column - 1;
+        if (i >= length)
+            return;
+        string += i;
+        length -= i;
+        column = -1;
+    }
+    n = t6963c_columns - column;
+    if (n > length)
+        n = length;
+    if (n <= 0)
+        return;
+
+    for (i = 0; i < n; i++) {
+        c = string[i] - font->first;
+        shifted[i] = c < font->count ? font->shifted + (c * 8 + s) * 8 : NULL;
+    }
+    for (row = 0; row < 8; row++) {
+        line[0] = 0x00;
+        for (i = 0; i < n; i++) {
+            bits = shifted[i] ? shifted[i][row] : 0;
+            line[i] |= bits >> 8;
+            line[i + 1] = bits;
+        }
+        t6963c_blit_line(y + row, column, line, s, 8 * n, rop);
+    }
+}
@@ -0,0 +1,154 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_graphics.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Graphics on the graphic area of the T6963C. Drawing is done in a framebuffer
+ * in RAM, which remembers per pixel row which bytes have changed.
+ * t6963c_graphics_flush() then writes only those bytes to the LCD.
+ *
+ * The graphic area is only shown as pixels when the LCD is not in text
+ * attribute mode; t6963c_graphics_init() sets OR mode. This assumes an 8 pixel
+ * wide font, so that every byte holds 8 pixels, the leftmost in bit 7.
+ */
+
+#ifndef T6963C_GRAPHICS_H
+#define	T6963C_GRAPHICS_H
+
+#include "t6963c.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define t6963c_width (t6963c_columns * 8)   // Width in pixels
+#define t6963c_height (t6963c_rows * 8)     // Height in pixels
+
+/**
+ * The type the blitter works with. Wider types move more pixels at a time.
+ */
+#ifndef t6963c_word
+#define t6963c_word unsigned long
+#endif
+
+// Raster operations, to combine a bitmap with what is already on the screen
+#define t6963c_rop_copy 0       // replace
+#define t6963c_rop_or 1         // set the pixels that are set in the bitmap
+#define t6963c_rop_andnot 2     // clear the pixels that are set in the bitmap
+#define t6963c_rop_xor 3        // invert the pixels that are set in the bitmap
+
+/**
+ * A font of 8x8 glyphs, with every glyph stored for each of the 8 possible
+ * pixel offsets within a byte. Drawing a string then only takes copying bytes.
+ */
+typedef struct T6963C_Font {
+    unsigned char first;        // code of the first glyph
+    unsigned char count;        // number of glyphs
+    unsigned short* shifted;    // per glyph, per offset, per row: 16 pixels
+} T6963C_Font;
+
+/**
+ * The number of unsigned shorts a T6963C_Font cache needs for count glyphs
+ */
+#define t6963c_font_cache_size(count) ((count) * 64)
+
+/**
+ * Set the LCD in OR mode, so that graphics are shown on top of the text, and
+ * clear the graphic area.
+ */
+void t6963c_graphics_init(void);
+
+/**
+ * Clear the framebuffer
+ */
+void t6963c_graphics_clear(void);
+
+/**
+ * Write the changed parts of the framebuffer to the LCD
+ */
+void t6963c_graphics_flush(void);
+
+/**
+ * Set or clear a pixel. Pixels outside of the screen are ignored, here and in
+ * the functions below.
+ * @param on whether the pixel should be set (1) or cleared (0)
+ */
+void t6963c_pixel(int x, int y, unsigned on);
+
+/**
+ * Check whether a pixel is set in the framebuffer
+ */
+unsigned t6963c_get_pixel(int x, int y);
+
+/**
+ * Draw a line from (x0,y0) to (x1,y1), including both ends
+ */
+void t6963c_line(int x0, int y0, int x1, int y1, unsigned on);
+
+/**
+ * Draw the outline of a rectangle of width w and height h
+ */
+void t6963c_rect(int x, int y, int w, int h, unsigned on);
+
+/**
+ * Fill a rectangle of width w and height h
+ */
+void t6963c_fill(int x, int y, int w, int h, unsigned on);
+
+/**
+ * Copy a bitmap of width w and height h to (x,y). The bitmap is stored row by
+ * row, each row in (w + 7) / 8 bytes with the leftmost pixel in bit 7.
+ */
+void t6963c_blit(int x, int y, const unsigned char* bitmap, int w, int h);
+
+/**
+ * Like t6963c_blit, but combine the bitmap with the screen using a raster
+ * operation. The bitmap is shifted and combined a word at a time.
+ * @param rop t6963c_rop_copy, t6963c_rop_or, t6963c_rop_andnot or
+ *   t6963c_rop_xor
+ */
+void t6963c_blit_rop(int x, int y, const unsigned char* bitmap, int w, int h,
+        unsigned char rop);
+
+/**
+ * Set up a font
+ * @param glyphs 8 bytes per glyph, the top row first and the leftmost pixel in
+ *   bit 7. This is no longer needed afterwards.
+ * @param first the character code of the first glyph
+ * @param count the number of glyphs
+ * @param cache room for t6963c_font_cache_size(count) unsigned shorts
+ */
+void t6963c_font_init(T6963C_Font*, const unsigned char* glyphs,
+        unsigned char first, unsigned char count, unsigned short* cache);
+
+/**
+ * Draw a string with its top left corner at (x,y). Characters without a glyph
+ * are drawn as blanks.
+ * @param rop see t6963c_blit_rop
+ */
+void t6963c_text(int x, int y, const T6963C_Font*, const char* string,
+        unsigned char rop);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_GRAPHICS_H */
@@ -0,0 +1,131 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_plan.h"
+
+// A gap longer than this is never worth rewriting in an auto write run
+#define t6963c_plan_max_gap ((t6963c_cost_address + \
+        2 * (t6963c_byte_ns + t6963c_auto_mode_ns)) / \
+        (t6963c_byte_ns + t6963c_auto_ns))
+
+static unsigned char t6963c_popcount(unsigned char bits) {
+    unsigned char n = 0;
+    for (; bits; bits &= bits - 1)
+        n++;
+    return n;
+}
+
+unsigned long t6963c_plan(T6963C_Plan* plan, const T6963C_Span* spans,
+        unsigned char n, unsigned short address) {
+    // For spans i .. n-1, with the address pointer at the end of span i-1
+    // (p = 0) or at its last byte (p = 1): the least cost, and the step to
+    // take for it, which covers spans i .. next-1.
+    unsigned long cost[t6963c_plan_size + 1][2], c, setup;
+    unsigned char type[t6963c_plan_size][2], next[t6963c_plan_size][2];
+    unsigned short pointer, end;
+    unsigned char i, j, p;
+
+    cost[n][0] = cost[n][1] = 0;
+    for (i = n; i-- > 0;) {
+        for (p = 0; p < 2; p++) {
+            if (i == 0)
+                pointer = address;
+            else
+                pointer = spans[i - 1].address + spans[i - 1].length - p;
+            setup = pointer == spans[i].address ? 0 : t6963c_cost_address;
+
+            cost[i][p] = setup + t6963c_cost_write(spans[i].length) +
+                    cost[i + 1][0];
+            type[i][p] = t6963c_step_write;
+            next[i][p] = i + 1;
+
+            if (spans[i].length == 1 && spans[i].bits) {
+                c = setup + t6963c_cost_bit(t6963c_popcount(spans[i].bits)) +
+                        cost[i + 1][1];
+                if (c < cost[i][p]) {
+                    cost[i][p] = c;
+                    type[i][p] = t6963c_step_bit;
+                }
+            }
+
+            end = spans[i].address;
+            for (j = i + 1; j <= n; j++) {
+                if (spans[j - 1].address - end > t6963c_plan_max_gap)
+                    break;
+                end = spans[j - 1].address + spans[j - 1].length;
+                c = setup + t6963c_cost_auto(end - spans[i].address) + 
+                        cost[j][0];
+                if (c < cost[i][p]) {
+                    cost[i][p] = c;
+                    type[i][p] = t6963c_step_auto;
+                    next[i][p] = j;
+                }
+            }
+        }
+    }
+
+    plan->length = 0;
+    plan->ns = n ? cost[0][0] : 0;
+    pointer = address;
+    for (i = 0, p = 0; i < n; i = j) {
+        T6963C_Step* step = &plan->steps[plan->length++];
+        j = next[i][p];
+        step->type = type[i][p];
+        step->set_address = pointer != spans[i].address;
+        step->address = spans[i].address;
+        end = spans[j - 1].address + spans[j - 1].length;
+        if (step->type == t6963c_step_bit) {
+            step->length = spans[i].bits;
+            pointer = spans[i].address;
+            p = 1;
+        } else {
+            step->length = end - spans[i].address;
+            pointer = end;
+            p = 0;
+        }
+    }
+    return plan->ns;
+}
+
+void t6963c_plan_run(const T6963C_Plan* plan, const unsigned char* data,
+        unsigned short base) {
+    const T6963C_Step* step;
+    const unsigned char* bytes;
+    unsigned short i;
+    unsigned char bit;
+
+    for (step = plan->steps; step < plan->steps + plan->length; step++) {
+        bytes = data + (step->address - base);
+        if (step->set_address)
+            t6963c_writeCmd2(0x24, step->address & 0xff, step->address >> 8);
+        if (step->type == t6963c_step_auto) {
+            t6963c_startAutoWrite();
+            t6963c_autoWriteRun((const char*) bytes, step->length);
+            t6963c_stopAutoWrite();
+        } else if (step->type == t6963c_step_write) {
+            for (i = 0; i < step->length; i++)
+                t6963c_writeCmd1(0xc0, bytes[i]);
+        } else {
+            for (bit = 0; bit < 8; bit++)
+                if (step->length & (1 << bit))
+                    t6963c_writeCmd0((bytes[0] & (1 << bit) ? 0xf8 : 0xf0) | 
+                            bit);
+        }
+    }
+}
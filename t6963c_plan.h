@@ -0,0 +1,106 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_plan.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Plans how to write a number of changed spans of display RAM in the least
+ * time. There are three ways to write data:
+ *
+ *  - An auto write run (0xB0 .. 0xB2). This has a high fixed cost, but every
+ *    byte is cheap. Short gaps between spans may be rewritten to save setting
+ *    a new address.
+ *  - Data writes with increment (0xC0). Every byte is a command, but there is
+ *    no fixed cost.
+ *  - Bit set and reset (0xF0 .. 0xFF). One command per bit, without data
+ *    byte. This is only possible when it is known which bits have changed.
+ *
+ * Each of these may have to be preceded by setting the address pointer. The
+ * costs are estimated with the t6963c_cost_* macros of t6963c.h.
+ */
+
+#ifndef T6963C_PLAN_H
+#define	T6963C_PLAN_H
+
+#include "t6963c.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifndef t6963c_plan_size
+#define t6963c_plan_size 32             // Maximum number of spans in a plan
+#endif
+
+// Types of steps
+#define t6963c_step_auto 0      // auto write run
+#define t6963c_step_write 1     // data writes with increment
+#define t6963c_step_bit 2       // bit set and reset
+
+/**
+ * A changed part of the display RAM
+ */
+typedef struct T6963C_Span {
+    unsigned short address;
+    unsigned short length;
+    unsigned char bits;         // for a single byte: the bits that may have
+                                // changed; 0 when unknown
+} T6963C_Span;
+
+/**
+ * A step of a plan: one way of writing, possibly after setting the address
+ */
+typedef struct T6963C_Step {
+    unsigned char type;         // t6963c_step_*
+    unsigned char set_address;  // whether the address pointer is set first
+    unsigned short address;
+    unsigned short length;      // number of bytes, or for t6963c_step_bit the
+                                // mask of bits to write
+} T6963C_Step;
+
+typedef struct T6963C_Plan {
+    T6963C_Step steps[t6963c_plan_size];
+    unsigned char length;       // number of steps
+    unsigned long ns;           // estimated time
+} T6963C_Plan;
+
+/**
+ * Find the quickest way to write a number of spans
+ * @param spans sorted by address and not overlapping
+ * @param n the number of spans, at most t6963c_plan_size
+ * @param address the address pointer of the LCD
+ * @return the estimated time in ns
+ */
+unsigned long t6963c_plan(T6963C_Plan*, const T6963C_Span* spans,
+        unsigned char n, unsigned short address);
+
+/**
+ * Execute a plan. The LCD should not be in auto write mode.
+ * @param data the data to write: the byte for address a is data[a - base]
+ * @param base the address of the first byte of data
+ */
+void t6963c_plan_run(const T6963C_Plan*, const unsigned char* data,
+        unsigned short base);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_PLAN_H */
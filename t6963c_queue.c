@@ -0,0 +1,154 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_queue.h"
+
+#define t6963c_op_cmd 0     // a command with data bytes
+#define t6963c_op_run 1     // an auto write run
+#define t6963c_op_sync 2    // bring the text RAM in sync with the frame
+
+typedef struct {
+    unsigned char type;
+    unsigned char n;        // number of data bytes of a command
+    char cmd, data1, data2;
+    unsigned short address; // start address of a run
+    const char* data;       // data of a run
+    unsigned short length;  // length of a run
+} T6963C_Op;
+
+// Volatile, so that an operation is stored before the tail that publishes it
+static volatile T6963C_Op t6963c_queue[t6963c_queue_size];
+static volatile unsigned int t6963c_queue_head;  // ticket of the current op
+static volatile unsigned int t6963c_queue_tail;  // ticket of the next new op
+static unsigned int t6963c_queue_sync;           // ticket of the last sync op
+static unsigned int t6963c_queue_step;           // step in the current op
+static unsigned long t6963c_queue_wait;          // ns to wait before a step
+
+/**
+ * Add an operation to the queue
+ * @return its ticket, or 0 if the queue is full
+ */
+static unsigned int t6963c_queue_add(T6963C_Op* op) {
+    unsigned int ticket = t6963c_queue_tail;
+    if (ticket - t6963c_queue_head == t6963c_queue_size)
+        return 0;
+    t6963c_queue[ticket % t6963c_queue_size] = *op;
+    t6963c_queue_tail = ticket + 1;
+    return ticket + 1;
+}
+
+unsigned int t6963c_queue_cmd(char cmd, unsigned char n, char data1, char data2) {
+    T6963C_Op op;
+    op.type = t6963c_op_cmd;
+    op.cmd = cmd;
+    op.n = n;
+    op.data1 = data1;
+    op.data2 = data2;
+    return t6963c_queue_add(&op);
+}
+
+unsigned int t6963c_queue_run(unsigned short address, const char* data,
+        unsigned short length) {
+    T6963C_Op op;
+    op.type = t6963c_op_run;
+    op.address = address;
+    op.data = data;
+    op.length = length;
+    return t6963c_queue_add(&op);
+}
+
+unsigned int t6963c_queue_terminal(Terminal* term) {
+    T6963C_Op op;
+    t6963c_queue_lock();
+    t6963c_render_terminal(term);
+    t6963c_queue_unlock();
+    if (t6963c_queue_sync && !t6963c_queue_done(t6963c_queue_sync))
+        return t6963c_queue_sync;
+    op.type = t6963c_op_sync;
+    return t6963c_queue_sync = t6963c_queue_add(&op);
+}
+
+void t6963c_update_terminal_async(Terminal* term) {
+    t6963c_queue_terminal(term);
+}
+
+/**
+ * Do the next step of an operation
+ * @return the time in ns to wait before the next step, or 0 if the operation
+ *   has been completed
+ */
+static unsigned long t6963c_queue_do(volatile T6963C_Op* op) {
+    unsigned int step = t6963c_queue_step++;
+    if (op->type == t6963c_op_cmd) {
+        if (step)
+            return 0;
+        t6963c_sendCmd(op->cmd, op->n, op->data1, op->data2);
+        return t6963c_cmd_ns;
+    } else if (op->type == t6963c_op_run) {
+        if (step == 0) {
+            t6963c_sendCmd(0x24, 2, op->address & 0xff, op->address >> 8);
+            return t6963c_cmd_ns;
+        } else if (step == 1) {
+            t6963c_sendCmd(0xb0, 0, 0, 0);
+            return t6963c_auto_mode_ns;
+        } else if (step < op->length + 2u) {
+            t6963c_sendAuto(op->data[step - 2]);
+            return t6963c_auto_ns;
+        } else if (step == op->length + 2u) {
+            t6963c_sendCmd(0xb2, 0, 0, 0);
+            return t6963c_auto_mode_ns;
+        }
+        return 0;
+    } else {
+        return t6963c_sync_step();
+    }
+}
+
+void t6963c_queue_tick(unsigned long ns) {
+    unsigned long wait;
+
+    if (t6963c_queue_wait > ns) {
+        t6963c_queue_wait -= ns;
+#ifdef t6963c_status_check
+        if (!t6963c_ready())
+            return;
+#else
+        return;
+#endif
+    }
+    t6963c_queue_wait = 0;
+
+    while (t6963c_queue_head != t6963c_queue_tail) {
+        wait = t6963c_queue_do(&t6963c_queue[t6963c_queue_head % t6963c_queue_size]);
+        if (wait) {
+            t6963c_queue_wait = wait;
+            return;
+        }
+        t6963c_queue_step = 0;
+        t6963c_queue_head++;
+    }
+}
+
+unsigned int t6963c_queue_depth(void) {
+    return t6963c_queue_tail - t6963c_queue_head;
+}
+
+unsigned t6963c_queue_done(unsigned int ticket) {
+    return (int) (t6963c_queue_head - ticket) >= 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_queue.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * A non-blocking output path for the T6963C library. Operations are put in a
+ * bounded queue and return immediately. The queue is drained by calling
+ * t6963c_queue_tick() periodically, typically from a timer interrupt. Each
+ * tick does at most one step on the bus (a command, or one byte in auto write
+ * mode), and only when the LCD has had time to process the previous step.
+ *
+ * Every queued operation gets a ticket, which can be used to check whether it
+ * has been completed.
+ *
+ * The blocking functions of t6963c.h should not be used while the queue is not
+ * empty.
+ */
+
+#ifndef T6963C_QUEUE_H
+#define	T6963C_QUEUE_H
+
+#include "t6963c.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifndef t6963c_queue_size
+#define t6963c_queue_size 16            // Maximum number of queued operations
+#endif
+
+// Mask and unmask the interrupt that calls t6963c_queue_tick(). The frame is
+// rendered while these are in effect, so that a tick does not sync a half
+// rendered frame. Define them when t6963c_queue_terminal() is called outside
+// that interrupt, for example on a PIC32:
+// #define t6963c_queue_lock()   IEC0CLR = _IEC0_T3IE_MASK
+// #define t6963c_queue_unlock() IEC0SET = _IEC0_T3IE_MASK
+#ifndef t6963c_queue_lock
+#define t6963c_queue_lock()
+#endif
+#ifndef t6963c_queue_unlock
+#define t6963c_queue_unlock()
+#endif
+
+/**
+ * Queue a command with n (0, 1 or 2) data bytes
+ * @return the ticket of the operation, or 0 if the queue is full
+ */
+unsigned int t6963c_queue_cmd(char cmd, unsigned char n, char data1, char data2);
+
+/**
+ * Queue an auto write run of length bytes at an address. The data is not
+ * copied, and should not be changed until the operation has been completed.
+ * @return the ticket of the operation, or 0 if the queue is full
+ */
+unsigned int t6963c_queue_run(unsigned short address, const char* data,
+        unsigned short length);
+
+/**
+ * Render a Terminal and queue bringing the LCD in sync with it. If this is
+ * already queued and not yet completed, the new rendering is picked up by the
+ * same operation and its ticket is returned. Rendering is done between
+ * t6963c_queue_lock() and t6963c_queue_unlock().
+ * @return the ticket of the operation, or 0 if the queue is full
+ */
+unsigned int t6963c_queue_terminal(Terminal*);
+
+/**
+ * Like t6963c_queue_terminal, but may be used as a callback from a
+ * Terminal.update.
+ */
+void t6963c_update_terminal_async(Terminal*);
+
+/**
+ * Do the next step on the bus, if the LCD is ready for it.
+ * @param ns the time in ns since the last tick
+ */
+void t6963c_queue_tick(unsigned long ns);
+
+/**
+ * The number of operations in the queue, including the current one
+ */
+unsigned int t6963c_queue_depth(void);
+
+/**
+ * Check whether an operation has been completed
+ */
+unsigned t6963c_queue_done(unsigned int ticket);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_QUEUE_H */
@@ -0,0 +1,104 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_refresh.h"
+#include <stddef.h>
+#include <string.h>
+
+static unsigned long t6963c_refresh_now(T6963C_Refresh* refresh) {
+    return refresh->clock ? refresh->clock() : t6963c_timestamp();
+}
+
+void t6963c_refresh_setup(T6963C_Refresh* refresh, T6963C_Display* display,
+        unsigned long (*clock)(void), unsigned long interval,
+        unsigned long deadline) {
+    refresh->display = display;
+    refresh->clock = clock;
+    refresh->interval = interval;
+    refresh->deadline = deadline;
+    refresh->terminal = NULL;
+    memset(&refresh->change, 0, sizeof(TerminalChange));
+    refresh->stale = 0;
+    refresh->last = t6963c_refresh_now(refresh) - interval;
+    refresh->updates = refresh->coalesced = refresh->missed = 0;
+}
+
+/**
+ * Add a change of the Terminal to the changes that are not yet written
+ */
+static void t6963c_refresh_merge(TerminalChange* changes,
+        const TerminalChange* change) {
+    if (!change->changed)
+        return;
+    if (!changes->changed || change->from < changes->from)
+        changes->from = change->from;
+    changes->changed = 1;
+    changes->appended += change->appended;
+    changes->discarded += change->discarded;
+    changes->dropped += change->dropped;
+}
+
+/**
+ * Update the display, and count whether that was in time. The update sees all
+ * changes since the last one, also those of callbacks that had to wait.
+ */
+static void t6963c_refresh_run(T6963C_Refresh* refresh, unsigned long now) {
+    TerminalChange change = refresh->terminal->change;
+    if (now - refresh->stale_at > refresh->deadline)
+        refresh->missed++;
+    refresh->stale = 0;
+    refresh->last = now;
+    refresh->updates++;
+    refresh->terminal->change = refresh->change;
+    t6963c_display_update_terminal(refresh->display, refresh->terminal);
+    refresh->terminal->change = change;
+    memset(&refresh->change, 0, sizeof(TerminalChange));
+}
+
+unsigned t6963c_refresh_tick(T6963C_Refresh* refresh) {
+    unsigned long now;
+    if (!refresh->stale)
+        return 0;
+    now = t6963c_refresh_now(refresh);
+    if (now - refresh->last < refresh->interval &&
+            now - refresh->stale_at < refresh->deadline)
+        return 0;
+    t6963c_refresh_run(refresh, now);
+    return 1;
+}
+
+void t6963c_refresh_flush(T6963C_Refresh* refresh) {
+    if (refresh->stale)
+        t6963c_refresh_run(refresh, t6963c_refresh_now(refresh));
+}
+
+void t6963c_update_terminal_scheduled(Terminal* term) {
+    T6963C_Refresh* refresh = (T6963C_Refresh*) term->data;
+    if (refresh->terminal != term)
+        memset(&refresh->change, 0, sizeof(TerminalChange));
+    t6963c_refresh_merge(&refresh->change, &term->change);
+    if (refresh->stale && refresh->terminal == term) {
+        refresh->coalesced++;
+    } else if (!refresh->stale) {
+        refresh->stale = 1;
+        refresh->stale_at = t6963c_refresh_now(refresh);
+    }
+    refresh->terminal = term;
+    t6963c_refresh_tick(refresh);
+}
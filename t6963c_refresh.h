@@ -0,0 +1,101 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_refresh.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * A rate-limited refresh of a display with a Terminal. Changes to the Terminal
+ * only mark the display stale; it is updated at most once per interval, so
+ * that a burst of changes is written as one update. A stale display that has
+ * waited for deadline is updated even if the interval has not yet passed.
+ *
+ * Use t6963c_update_terminal_scheduled as the update callback, with a
+ * T6963C_Refresh as Terminal.data, and call t6963c_refresh_tick() regularly,
+ * for example from the main loop, to write changes that had to wait.
+ *
+ * Times are read from a clock function, which may be replaced, for example by
+ * a test clock on a host. By default, t6963c_timestamp() is used, and times
+ * are in its ticks; use t6963c_ticks() to convert from ns.
+ */
+
+#ifndef T6963C_REFRESH_H
+#define	T6963C_REFRESH_H
+
+#include "t6963c.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+typedef struct T6963C_Refresh {
+    T6963C_Display* display;
+    unsigned long (*clock)(void);       // free-running clock, or NULL for
+                                        // t6963c_timestamp()
+    unsigned long interval;             // minimum time between updates
+    unsigned long deadline;             // maximum time a change may wait
+
+    Terminal* terminal;                 // Terminal to show
+    TerminalChange change;              // changes of it not yet written
+    unsigned stale;                     // whether the display is stale
+    unsigned long stale_at;             // when it became stale
+    unsigned long last;                 // when the last update started
+
+    unsigned long updates;              // updates done
+    unsigned long coalesced;            // changes that did not need their own
+                                        // update
+    unsigned long missed;               // updates done after their deadline
+} T6963C_Refresh;
+
+/**
+ * Set up a refresh of a display. The counters are set to zero. The first
+ * change is written immediately.
+ * @param clock the clock for all times, or NULL for t6963c_timestamp()
+ * @param interval the minimum time between updates, for example
+ *   t6963c_ticks(1000000000 / 25) for at most 25 updates per second
+ * @param deadline the maximum time a change may wait to be written
+ */
+void t6963c_refresh_setup(T6963C_Refresh*, T6963C_Display*,
+        unsigned long (*clock)(void), unsigned long interval,
+        unsigned long deadline);
+
+/**
+ * Update the display if it is stale and the interval has passed, or the
+ * deadline of the oldest change has come.
+ * @return 1 if the display was updated, 0 otherwise
+ */
+unsigned t6963c_refresh_tick(T6963C_Refresh*);
+
+/**
+ * Update the display now if it is stale, regardless of the interval
+ */
+void t6963c_refresh_flush(T6963C_Refresh*);
+
+/**
+ * Mark the display of the T6963C_Refresh in Terminal.data stale, and update it
+ * if that is allowed already. May be used as a callback from a
+ * Terminal.update.
+ */
+void t6963c_update_terminal_scheduled(Terminal*);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_REFRESH_H */
@@ -0,0 +1,154 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_replay.c
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Replays a trace of t6963c_trace.h into a simulated controller. The totals
+ * are printed as one line of JSON, like the results of t6963c_bench.c:
+ *
+ *     {"trace":"log.trace","events":...,"bytes":...,"commands":...,...}
+ *
+ * bytes and commands count the bytes written, reads the status reads, and ns
+ * the time from the start of the recording to the last event. violations
+ * counts bytes written while the simulated controller would have been busy.
+ * incomplete is 1 if the trace ends in the middle of an event, or 0.
+ *
+ * After that, the text area and, in attribute mode, the attribute area are
+ * rendered, one row per line. Attributes are shown as a hexadecimal digit per
+ * cell.
+ *
+ * Usage: t6963c_replay trace [rows [columns]]
+ */
+
+#include "t6963c_sim.h"
+#include "t6963c_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Read a file into memory
+ * @return the contents, to be freed, or NULL on failure
+ */
+static unsigned char* replay_read(const char* name, unsigned long* length) {
+    FILE* file = fopen(name, "rb");
+    unsigned char* contents = NULL;
+    unsigned char* bigger;
+    unsigned long size = 0;
+    size_t n;
+
+    if (!file)
+        return NULL;
+    *length = 0;
+    do {
+        if (*length == size) {
+            size = size ? 2 * size : 4096;
+            if (!(bigger = realloc(contents, size))) {
+                free(contents);
+                fclose(file);
+                return NULL;
+            }
+            contents = bigger;
+        }
+        n = fread(contents + *length, 1, size - *length, file);
+        *length += n;
+    } while (n);
+    fclose(file);
+    return contents;
+}
+
+static void replay_attributes(T6963C_Sim* sim, unsigned int rows,
+        unsigned int columns) {
+    unsigned int row, column;
+    unsigned char attr;
+    for (row = 0; row < rows; row++) {
+        for (column = 0; column < columns; column++) {
+            attr = sim->ram[(sim->graphic_home + row * sim->graphic_area + 
+                    column) % t6963c_sim_ram_size] & 0x0f;
+            putchar(attr < 10 ? '0' + attr : 'a' + attr - 10);
+        }
+        putchar('\n');
+    }
+}
+
+int main(int argc, char** argv) {
+    static T6963C_Sim sim;
+    T6963C_Event event;
+    unsigned char* trace;
+    char* screen;
+    unsigned long length, pos, next, nspertick, events = 0, resets = 0;
+    unsigned long long ticks = 0;
+    unsigned int rows = t6963c_rows, columns;
+
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "Usage: %s trace [rows [columns]]\n", argv[0]);
+        return 2;
+    }
+    if (!(trace = replay_read(argv[1], &length))) {
+        perror(argv[1]);
+        return 1;
+    }
+    if (!(pos = t6963c_trace_header(trace, length, &nspertick))) {
+        fprintf(stderr, "%s: not a trace of version %d\n", argv[1],
+                t6963c_trace_version);
+        free(trace);
+        return 1;
+    }
+
+    t6963c_sim_init(&sim);
+    t6963c_sim_ns = 0;
+    for (; pos < length && (next = t6963c_trace_next(trace, length, pos, 
+            &event)); pos = next) {
+        events++;
+        ticks += event.ticks;
+        t6963c_sim_ns = ticks * nspertick;
+        if (event.kind == t6963c_event_reset) {
+            t6963c_sim_bus_reset(&sim);
+            resets++;
+        } else if (event.kind == t6963c_event_status) {
+            sim.reads++;
+        } else {
+            t6963c_sim_write(&sim, event.kind == t6963c_event_command,
+                    event.byte);
+        }
+    }
+
+    printf("{\"trace\":\"%s\",\"events\":%lu,\"bytes\":%lu,\"commands\":%lu,"
+            "\"auto_writes\":%lu,\"reads\":%lu,\"resets\":%lu,\"ns\":%llu,"
+            "\"violations\":%lu,\"incomplete\":%d}\n",
+            argv[1], events, sim.writes, sim.commands, sim.auto_writes,
+            sim.reads, resets, t6963c_sim_ns, sim.violations, pos < length);
+    free(trace);
+
+    if (argc > 2)
+        rows = atoi(argv[2]);
+    columns = argc > 3 ? atoi(argv[3]) : 
+            sim.text_area ? sim.text_area : t6963c_columns;
+    if (!(screen = malloc(rows * (columns + 1) + 1)))
+        return 1;
+    t6963c_sim_screen(&sim, screen, rows, columns);
+    fputs(screen, stdout);
+    free(screen);
+    if ((sim.mode & 0x07) == t6963c_mode_attr) {
+        putchar('\n');
+        replay_attributes(&sim, rows, columns);
+    }
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_sim.h"
+#include <string.h>
+
+T6963C_Sim t6963c_sim = {
+    .rst = 1, .cd = 1, .ce = 1, .rd = 1, .wr = 1,
+    .cmd_ns = t6963c_sim_cmd_ns,
+    .auto_ns = t6963c_sim_auto_ns
+};
+
+unsigned long long t6963c_sim_ns;
+unsigned long long t6963c_sim_delay_ns;
+unsigned long t6963c_sim_read_ns = t6963c_nspertick;
+
+void t6963c_sim_init(T6963C_Sim* sim) {
+    memset(sim, 0, sizeof(T6963C_Sim));
+    sim->rst = sim->cd = sim->ce = sim->rd = sim->wr = 1;
+    sim->cmd_ns = t6963c_sim_cmd_ns;
+    sim->auto_ns = t6963c_sim_auto_ns;
+}
+
+/**
+ * Reset the registers of a controller, as the RESET line does
+ */
+static void t6963c_sim_reset(T6963C_Sim* sim) {
+    sim->address = 0;
+    sim->cursor_x = sim->cursor_y = 0;
+    sim->offset = 0;
+    sim->text_home = sim->text_area = 0;
+    sim->graphic_home = sim->graphic_area = 0;
+    sim->mode = sim->display = sim->cursor_pattern = 0;
+    sim->nargs = 0;
+    sim->auto_mode = 0;
+    sim->ready_at = t6963c_sim_ns;
+}
+
+static unsigned short t6963c_sim_arg16(T6963C_Sim* sim) {
+    return sim->args[0] | (sim->args[1] << 8);
+}
+
+static void t6963c_sim_command(T6963C_Sim* sim, unsigned char cmd) {
+    sim->commands++;
+    if (cmd == 0x21) {
+        sim->cursor_x = sim->args[0];
+        sim->cursor_y = sim->args[1];
+    } else if (cmd == 0x22) {
+        sim->offset = sim->args[0] & 0x1f;
+    } else if (cmd == 0x24) {
+        sim->address = t6963c_sim_arg16(sim);
+    } else if (cmd == 0x40) {
+        sim->text_home = t6963c_sim_arg16(sim);
+    } else if (cmd == 0x41) {
+        sim->text_area = t6963c_sim_arg16(sim);
+    } else if (cmd == 0x42) {
+        sim->graphic_home = t6963c_sim_arg16(sim);
+    } else if (cmd == 0x43) {
+        sim->graphic_area = t6963c_sim_arg16(sim);
+    } else if ((cmd & 0xf0) == 0x80) {
+        sim->mode = cmd & 0x0f;
+    } else if ((cmd & 0xf0) == 0x90) {
+        sim->display = cmd & 0x0f;
+    } else if ((cmd & 0xf8) == 0xa0) {
+        sim->cursor_pattern = cmd & 0x07;
+    } else if (cmd == 0xb0) {
+        sim->auto_mode = 1;
+    } else if (cmd == 0xb1) {
+        sim->auto_mode = 2;
+    } else if (cmd == 0xb2 || cmd == 0xb3) {
+        sim->auto_mode = 0;
+    } else if ((cmd & 0xf8) == 0xc0) {
+        if (cmd & 0x01)
+            sim->read_latch = sim->ram[sim->address % t6963c_sim_ram_size];
+        else
+            sim->ram[sim->address % t6963c_sim_ram_size] = sim->args[0];
+        if ((cmd & 0x06) == 0x00)
+            sim->address++;
+        else if ((cmd & 0x06) == 0x02)
+            sim->address--;
+    } else if ((cmd & 0xf0) == 0xf0) {
+        unsigned char* byte = &sim->ram[sim->address % t6963c_sim_ram_size];
+        if (cmd & 0x08)
+            *byte |= 1 << (cmd & 0x07);
+        else
+            *byte &= ~(1 << (cmd & 0x07));
+    }
+    sim->nargs = 0;
+    sim->ready_at = t6963c_sim_ns + sim->cmd_ns;
+}
+
+void t6963c_sim_write(T6963C_Sim* sim, unsigned cd, unsigned char byte) {
+    sim->writes++;
+    if (t6963c_sim_ns < sim->ready_at)
+        sim->violations++;
+    if (cd && sim->auto_mode && (byte & 0xfe) != 0xb2) {
+        sim->violations++;              // only auto reset is accepted
+    } else if (cd) {
+        t6963c_sim_command(sim, byte);
+    } else if (sim->auto_mode == 1) {
+        sim->ram[sim->address++ % t6963c_sim_ram_size] = byte;
+        sim->auto_writes++;
+        sim->ready_at = t6963c_sim_ns + sim->auto_ns;
+    } else {
+        sim->args[sim->nargs] = byte;
+        sim->nargs = !sim->nargs;
+    }
+}
+
+unsigned char t6963c_sim_read(T6963C_Sim* sim, unsigned cd) {
+    unsigned char status = 0;
+    sim->reads++;
+    if (!cd) {
+        if (sim->auto_mode == 2)
+            return sim->ram[sim->address++ % t6963c_sim_ram_size];
+        return sim->read_latch;
+    }
+    if (t6963c_sim_ns >= sim->ready_at) {
+        status |= 0x03;
+        if (sim->auto_mode == 1)
+            status |= 0x08;
+        else if (sim->auto_mode == 2)
+            status |= 0x04;
+    }
+    return status;
+}
+
+void t6963c_sim_screen(T6963C_Sim* sim, char* buffer,
+        unsigned int rows, unsigned int columns) {
+    unsigned int row, column;
+    unsigned char c;
+    for (row = 0; row < rows; row++) {
+        for (column = 0; column < columns; column++) {
+            c = sim->ram[(sim->text_home + row * sim->text_area + column)
+                    % t6963c_sim_ram_size] + 0x20;
+            *buffer++ = c >= 0x20 && c < 0x7f ? c : '?';
+        }
+        *buffer++ = '\n';
+    }
+    *buffer = '\0';
+}
+
+void t6963c_sim_bus_write(void* sim, unsigned cd, unsigned char byte) {
+    t6963c_sim_ns += t6963c_sim_tcds_ns + t6963c_sim_tce_ns + t6963c_sim_tdh_ns;
+    t6963c_sim_write((T6963C_Sim*) sim, cd, byte);
+}
+
+unsigned char t6963c_sim_bus_status(void* sim) {
+    t6963c_sim_ns += t6963c_sim_tcds_ns + t6963c_sim_tacc_ns + t6963c_sim_tdh_ns;
+    return t6963c_sim_read((T6963C_Sim*) sim, 1);
+}
+
+void t6963c_sim_bus_reset(void* sim) {
+    t6963c_sim_reset((T6963C_Sim*) sim);
+}
+
+void t6963c_sim_bus_command(void* sim, unsigned char cmd, unsigned char n,
+        unsigned char data1, unsigned char data2) {
+    if (n > 0)
+        t6963c_sim_bus_write(sim, 0, data1);
+    if (n > 1)
+        t6963c_sim_bus_write(sim, 0, data2);
+    t6963c_sim_bus_write(sim, 1, cmd);
+}
+
+void t6963c_sim_bus_run(void* sim, const unsigned char* bytes,
+        unsigned short n) {
+    unsigned long long ready_at;
+    unsigned short i;
+    for (i = 0; i < n; i++) {
+        ready_at = ((T6963C_Sim*) sim)->ready_at;
+        if (i && t6963c_sim_ns < ready_at) {
+            t6963c_sim_delay_ns += ready_at - t6963c_sim_ns;
+            t6963c_sim_ns = ready_at;
+        }
+        t6963c_sim_bus_write(sim, 0, bytes[i]);
+    }
+}
+
+void t6963c_sim_rst(unsigned x) {
+    if (!x && t6963c_sim.rst)
+        t6963c_sim_reset(&t6963c_sim);
+    t6963c_sim.rst = x;
+}
+
+/**
+ * Check that the data and C/D lines are held long enough after CE
+ */
+static void t6963c_sim_hold(void) {
+    if (t6963c_sim.ce && t6963c_sim_ns - t6963c_sim.ce_at < t6963c_sim_tdh_ns)
+        t6963c_sim.timing++;
+}
+
+void t6963c_sim_cd(unsigned x) {
+    if (x != t6963c_sim.cd) {
+        t6963c_sim_hold();
+        t6963c_sim.cd_at = t6963c_sim_ns;
+    }
+    t6963c_sim.cd = x;
+}
+
+/**
+ * The controller acts on the falling edge of CE, when either WR or RD is low.
+ */
+void t6963c_sim_ce(unsigned x) {
+    if (!x && t6963c_sim.ce) {
+        if (t6963c_sim_ns - t6963c_sim.cd_at < t6963c_sim_tcds_ns)
+            t6963c_sim.timing++;
+        if (t6963c_sim.rst && !t6963c_sim.wr)
+            t6963c_sim_write(&t6963c_sim, t6963c_sim.cd, t6963c_sim.data);
+        else if (t6963c_sim.rst && !t6963c_sim.rd)
+            t6963c_sim.out = t6963c_sim_read(&t6963c_sim, t6963c_sim.cd);
+    } else if (x && !t6963c_sim.ce) {
+        if (t6963c_sim_ns - t6963c_sim.ce_at < t6963c_sim_tce_ns)
+            t6963c_sim.timing++;
+    }
+    if (x != t6963c_sim.ce)
+        t6963c_sim.ce_at = t6963c_sim_ns;
+    t6963c_sim.ce = x;
+}
+
+void t6963c_sim_rd(unsigned x) {
+    t6963c_sim.rd = x;
+}
+
+void t6963c_sim_wr(unsigned x) {
+    t6963c_sim.wr = x;
+}
+
+void t6963c_sim_data(unsigned int x) {
+    if ((unsigned char) x != t6963c_sim.data)
+        t6963c_sim_hold();
+    t6963c_sim.data = x;
+}
+
+unsigned char t6963c_sim_data_in(void) {
+    if (!t6963c_sim.ce && 
+            t6963c_sim_ns - t6963c_sim.ce_at < t6963c_sim_tacc_ns)
+        t6963c_sim.timing++;
+    return t6963c_sim.out;
+}
+
+void t6963c_initTimer(void) {
+}
+
+unsigned long t6963c_timestamp(void) {
+    t6963c_sim_ns += t6963c_sim_read_ns;
+    t6963c_sim_delay_ns += t6963c_sim_read_ns;
+    return t6963c_sim_ns / t6963c_nspertick;
+}
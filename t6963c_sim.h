@@ -0,0 +1,188 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_sim.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * A simulated T6963C controller, to run the library on a host. It implements
+ * the pin and timer functions of t6963c_specific.h. Bytes written on the bus
+ * are decoded as the controller would, into a simulated display RAM.
+ *
+ * Time is simulated as well. The timer advances t6963c_sim_read_ns ns, by
+ * default one tick of t6963c_nspertick ns, every time it is read, so time only
+ * passes while the library waits. The controller is busy for a while after a
+ * command or auto write; bytes written while it is busy, and commands other
+ * than auto reset in auto mode, are counted as violations. Pin changes that
+ * come too soon after each other are counted as timing violations.
+ *
+ * Compile with t6963c_simulator defined to use this instead of the PIC32 code
+ * in t6963c_specific.h.
+ */
+
+#ifndef T6963C_SIM_H
+#define	T6963C_SIM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#ifndef t6963c_sim_ram_size
+#define t6963c_sim_ram_size 0x10000     // Size of the display RAM
+#endif
+#ifndef t6963c_sim_cmd_ns
+#define t6963c_sim_cmd_ns 10000         // Time the controller is busy after a command
+#endif
+#ifndef t6963c_sim_auto_ns
+#define t6963c_sim_auto_ns 1000         // Time the controller is busy after an auto write
+#endif
+
+// Minimum bus timing in ns, from the datasheet
+#define t6963c_sim_tcds_ns 100          // C/D setup before CE
+#define t6963c_sim_tce_ns 80            // CE pulse width
+#define t6963c_sim_tdh_ns 40            // data and C/D hold after CE
+#define t6963c_sim_tacc_ns 150          // access time, from CE to valid data
+
+#ifndef t6963c_nspertick
+#define t6963c_nspertick 25             // ns per tick of the simulated timer
+#endif
+
+typedef struct T6963C_Sim {
+    unsigned char ram[t6963c_sim_ram_size];
+
+    unsigned rst, cd, ce, rd, wr;     // pin levels
+    unsigned char data;               // data port as written by the host
+    unsigned char out;                // data port as driven by the controller
+
+    unsigned short address;           // address pointer
+    unsigned char cursor_x, cursor_y; // cursor pointer
+    unsigned char offset;             // offset register (CG RAM)
+    unsigned short text_home, text_area, graphic_home, graphic_area;
+    unsigned char mode, display, cursor_pattern;
+    unsigned char args[2];            // data bytes received for a command
+    unsigned nargs;
+    unsigned auto_mode;               // 0: off, 1: auto write, 2: auto read
+    unsigned char read_latch;         // byte for a data read
+
+    unsigned long cmd_ns, auto_ns;    // busy times
+    unsigned long long ready_at;      // time at which the controller is ready
+    unsigned long long cd_at;         // time of the last change of C/D
+    unsigned long long ce_at;         // time of the last change of CE
+
+    unsigned long writes;             // bytes written on the bus
+    unsigned long commands;           // command bytes
+    unsigned long auto_writes;        // bytes written in auto write mode
+    unsigned long reads;              // status and data reads
+    unsigned long violations;         // bytes written at the wrong time
+    unsigned long timing;             // pin changes that came too soon
+} T6963C_Sim;
+
+/**
+ * The controller that is connected to the pin functions
+ */
+extern T6963C_Sim t6963c_sim;
+
+/**
+ * The simulated time in ns, and the part of it that was spent in delays
+ */
+extern unsigned long long t6963c_sim_ns;
+extern unsigned long long t6963c_sim_delay_ns;
+
+/**
+ * The time in ns that passes with every read of the timer; by default one
+ * tick. With less, a wait may start in the middle of a tick; with more, ticks
+ * are skipped.
+ */
+extern unsigned long t6963c_sim_read_ns;
+
+/**
+ * Reset a simulated controller: clear the RAM, registers and statistics
+ */
+void t6963c_sim_init(T6963C_Sim*);
+
+/**
+ * Write a byte to a simulated controller
+ * @param cd whether this is a command (1) or data (0)
+ */
+void t6963c_sim_write(T6963C_Sim*, unsigned cd, unsigned char byte);
+
+/**
+ * Read a byte from a simulated controller
+ * @param cd whether to read the status (1) or data (0)
+ */
+unsigned char t6963c_sim_read(T6963C_Sim*, unsigned cd);
+
+/**
+ * Render the text area of a simulated controller as rows lines of columns
+ * characters, each followed by \n. Characters outside of the printable ASCII
+ * range are shown as '?'.
+ * @param buffer must hold rows * (columns + 1) + 1 bytes
+ */
+void t6963c_sim_screen(T6963C_Sim*, char* buffer,
+        unsigned int rows, unsigned int columns);
+
+/**
+ * Bus functions for a T6963C_Bus with a T6963C_Sim* as data, to connect
+ * another simulated controller than t6963c_sim. Every byte takes the minimum
+ * bus time of the datasheet.
+ */
+void t6963c_sim_bus_write(void* sim, unsigned cd, unsigned char byte);
+unsigned char t6963c_sim_bus_status(void* sim);
+void t6963c_sim_bus_reset(void* sim);
+
+/**
+ * Block functions for the same T6963C_Bus, as a backend with a parallel master
+ * port or DMA would provide them. A run waits for the controller to be ready
+ * before every byte after the first.
+ */
+void t6963c_sim_bus_command(void* sim, unsigned char cmd, unsigned char n,
+        unsigned char data1, unsigned char data2);
+void t6963c_sim_bus_run(void* sim, const unsigned char* bytes,
+        unsigned short n);
+
+void t6963c_sim_rst(unsigned);
+void t6963c_sim_cd(unsigned);
+void t6963c_sim_ce(unsigned);
+void t6963c_sim_rd(unsigned);
+void t6963c_sim_wr(unsigned);
+void t6963c_sim_data(unsigned int);
+unsigned char t6963c_sim_data_in(void);
+
+#define t6963c_rst(x)    t6963c_sim_rst(x)
+#define t6963c_cd(x)     t6963c_sim_cd(x)
+#define t6963c_ce(x)     t6963c_sim_ce(x)
+#define t6963c_rd(x)     t6963c_sim_rd(x)
+#define t6963c_wr(x)     t6963c_sim_wr(x)
+#define t6963c_t_rst(x)
+#define t6963c_t_cd(x)
+#define t6963c_t_ce(x)
+#define t6963c_t_rd(x)
+#define t6963c_t_wr(x)
+#define t6963c_data(x)   t6963c_sim_data(x)
+#define t6963c_t_data(x)
+#define t6963c_data_in() t6963c_sim_data_in()
+
+void t6963c_initTimer(void);
+unsigned long t6963c_timestamp(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_SIM_H */
@@ -17,24 +17,19 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
-#include <p32xxxx.h>
 #include "t6963c_specific.h"
+
+#ifndef t6963c_simulator
+
+#include <p32xxxx.h>
 #include "system_config.h"
 
 inline void t6963c_initTimer(void) {
+    // The core timer is always running
 }
 
-inline void t6963c_startTimer(void) {
-    T2CON = NULL;
-    PR2 = 0xffff;
-    TMR2 = NULL;
-    T2CONSET = 0xa000;
+inline unsigned long t6963c_timestamp(void) {
+    return _CP0_GET_COUNT();
 }
 
-inline unsigned short t6963c_getTimeNs(void) {
-    return TMR2 * t6963c_nspertick;
-}
-
-inline void t6963c_stopTimer(void) { 
-    T2CONCLR = 0xa000;
-}
+#endif
@@ -22,11 +22,17 @@
  * Author: Camil Staps
  *
  * Example of what you could put in a t6963c_specific.h.
+ * 
+ * When t6963c_simulator is defined, the simulated controller of t6963c_sim.h
+ * is used instead of the PIC32 pins and timer.
  */
 
 #ifndef T6963C_SPECIFIC_H
 #define	T6963C_SPECIFIC_H
 
+#ifdef t6963c_simulator
+#include "t6963c_sim.h"
+#else
 #include <p32xxxx.h>
 
 #define t6963c_rst(x)    LATBbits.LATB12   = x // RESET line
@@ -41,28 +47,34 @@
 #define t6963c_t_wr(x)   TRISBbits.TRISB11 = x // TRIS bit of WR pin
 #define t6963c_data(x)   LATB  = (LATB  & 0xff00) | x; // Data port (lowest 8 bits)
 #define t6963c_t_data(x) TRISB = (TRISB & 0xff00) | x; // TRIS register of data port
+#define t6963c_data_in() (PORTB & 0xff)                 // Read the data port
+#endif
+
+// #define t6963c_status_check          // Poll the status instead of waiting
     
 #define t6963c_rows 16                  // Number of rows of the LCD
 #define t6963c_columns 40               // Number of columns of the LCD
 
+#ifndef t6963c_simulator
+
 #ifdef	__cplusplus
 extern "C" {
 #endif
 
-#define t6963c_nspertick 25
+#define t6963c_nspertick 10             // Core timer: SYSCLK / 2 = 100MHz
     
 /**
  * Define the project-specific timer functions here
  * @see t6963c.h
  */
 inline void t6963c_initTimer(void);
-inline void t6963c_startTimer(void);
-inline unsigned short t6963c_getTimeNs(void);
-inline void t6963c_stopTimer(void);
+inline unsigned long t6963c_timestamp(void);
 
 #ifdef	__cplusplus
 }
 #endif
 
+#endif
+
 #endif	/* T6963C_SPECIFIC_H */
 
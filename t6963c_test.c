@@ -0,0 +1,776 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_test.c
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Tests of what the LCD shows, on a host against the simulated controller.
+ * Terminal, Screen and graphics workloads are written to the display, and the
+ * text, attribute and graphic areas of the simulated display RAM are compared
+ * with what they should show, which is worked out here independently of the
+ * driver. Every failed check is printed; the exit status is the number of
+ * failures, capped at 255.
+ *
+ * Usage: t6963c_test
+ */
+
+#include "t6963c.h"
+#include "t6963c_graphics.h"
+#include "t6963c_plan.h"
+#include "t6963c_queue.h"
+#include "t6963c_refresh.h"
+#include "t6963c_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int test_failures;
+
+#define test_check(condition) test_report(condition, #condition, __LINE__)
+
+static void test_report(unsigned ok, const char* condition, unsigned line) {
+    if (ok)
+        return;
+    printf("t6963c_test.c:%u: failed: %s\n", line, condition);
+    test_failures++;
+}
+
+static unsigned char test_text_at(unsigned int row, unsigned int column) {
+    return t6963c_sim.ram[(t6963c_sim.text_home + row * t6963c_sim.text_area + 
+            column) % t6963c_sim_ram_size] + 0x20;
+}
+
+static unsigned char test_attribute_at(unsigned int row, unsigned int column) {
+    return t6963c_sim.ram[(t6963c_sim.graphic_home + 
+            row * t6963c_sim.graphic_area + column) % t6963c_sim_ram_size];
+}
+
+static unsigned test_pixel_at(unsigned int x, unsigned int y) {
+    return (t6963c_sim.ram[(t6963c_sim.graphic_home + 
+            y * t6963c_sim.graphic_area + x / 8) % t6963c_sim_ram_size] >> 
+            (7 - x % 8)) & 1;
+}
+
+static void test_setup(void) {
+    t6963c_sim_init(&t6963c_sim);
+    t6963c_init();
+}
+
+/**
+ * Everything appended to the Terminal, with the attribute of every character
+ */
+static char test_log[1 << 16];
+static unsigned char test_log_attributes[1 << 16];
+static unsigned int test_log_length;
+
+/**
+ * Check that the LCD shows the last rows of test_log, wrapped at the end of
+ * every row and at \n, with the cursor after the last character
+ */
+static void test_check_log(void) {
+    static char chars[sizeof(test_log) * 2];
+    static unsigned char attributes[sizeof(test_log) * 2];
+    unsigned int i, cell = 0, first, row, column, bad = 0;
+    for (i = 0; i < test_log_length; i++) {
+        if (test_log[i] == '\n') {
+            do {
+                chars[cell] = ' ';
+                attributes[cell++] = t6963c_attr_normal;
+            } while (cell % t6963c_columns);
+        } else {
+            chars[cell] = test_log[i];
+            attributes[cell++] = test_log_attributes[i];
+        }
+    }
+    first = cell / t6963c_columns + 1 > t6963c_rows ? 
+            (cell / t6963c_columns + 1 - t6963c_rows) * t6963c_columns : 0;
+    for (row = 0; row < t6963c_rows; row++) {
+        for (column = 0; column < t6963c_columns; column++) {
+            i = first + row * t6963c_columns + column;
+            if (test_text_at(row, column) != (i < cell ? chars[i] : ' ') ||
+                    test_attribute_at(row, column) != 
+                    (i < cell ? attributes[i] : t6963c_attr_normal))
+                bad++;
+        }
+    }
+    test_check(!bad);
+    test_check((unsigned int) t6963c_sim.cursor_y * t6963c_columns +
+            t6963c_sim.cursor_x == cell - first);
+}
+
+/**
+ * Append lines, words and newlines with different attributes to a Terminal,
+ * so that it scrolls and wraps
+ */
+static void test_terminal_on(Terminal* term) {
+    static const unsigned char attributes[] = {t6963c_attr_normal, 
+            t6963c_attr_invert, t6963c_attr_blink, t6963c_attr_normal};
+    char text[64];
+    unsigned int i, j, n, failures = test_failures;
+
+    test_setup();
+    test_check(terminal.use_attributes(term));
+    term->update = t6963c_update_terminal;
+    test_log_length = 0;
+    srand(5);
+    for (i = 0; i < 600 && test_failures == failures; i++) {
+        terminal.set_attribute(term, attributes[rand() % 4]);
+        n = rand() % 3 ? rand() % 12 : 40 + rand() % 20;
+        for (j = 0; j < n; j++)
+            text[j] = rand() % 8 ? 'a' + rand() % 26 : '\n';
+        text[n] = '\0';
+        terminal.append(term, text);
+        memcpy(test_log + test_log_length, text, n);
+        memset(test_log_attributes + test_log_length, term->attribute, n);
+        test_log_length += n;
+        test_check_log();
+        if (test_log_length > sizeof(test_log) - 64)
+            break;
+    }
+    test_check(!t6963c_sim.violations);
+}
+
+/**
+ * The same for a Terminal on the heap and one in static storage; the index of
+ * the latter is kept in the display, so that updates do not allocate
+ */
+static void test_terminal(void) {
+    static Terminal fixed;
+    static char content[1024 + 1];
+    static unsigned char attributes[1024 + 1];
+    Terminal* term = terminal.construct_ring(1024);
+    
+    test_terminal_on(term);
+    terminal.free(term);
+    
+    terminal.init(&fixed, content, attributes, 1024, terminal_overflow_drop);
+    test_terminal_on(&fixed);
+    test_check(fixed.index == t6963c_default.index);
+    test_check(!fixed.index_allocated);
+    terminal.free(&fixed);
+}
+
+/**
+ * Write VT100 data to a Screen and check that the LCD shows its cells, with
+ * the attributes of t6963c_render_screen()
+ */
+static void test_screen(void) {
+    static const char* pieces[] = {
+        "hello", "\r\n", "\x1b[7m", "\x1b[0m", "\x1b[5m", "\x1b[8m",
+        "\x1b[2J", "\x1b[K", "\x1b[H", "\x1b[10;20H", "\x1b[3A", "\x1b[5C",
+        "\x1b" "D", "\x1b" "M", "\b", "\t", "world wide web ", "\x1b[4X"
+    };
+    Screen* scr;
+    unsigned char attribute;
+    unsigned int i, row, column, bad, failures = test_failures;
+
+    test_setup();
+    scr = screen.construct(t6963c_rows, t6963c_columns);
+    scr->update = t6963c_update_screen;
+    srand(7);
+    for (i = 0; i < 2000 && test_failures == failures; i++) {
+        screen.print(scr, pieces[rand() % (sizeof(pieces) / sizeof(char*))]);
+        bad = 0;
+        for (row = 0; row < t6963c_rows; row++) {
+            for (column = 0; column < t6963c_columns; column++) {
+                attribute = scr->attributes[row * t6963c_columns + column];
+                attribute = (attribute & screen_hidden ? t6963c_attr_inhibit :
+                        attribute & screen_reverse ? t6963c_attr_invert :
+                        t6963c_attr_normal) | 
+                        (attribute & screen_blink ? t6963c_attr_blink : 0);
+                if (test_text_at(row, column) != 
+                        (unsigned char) scr->chars[row * t6963c_columns + 
+                        column] || test_attribute_at(row, column) != attribute)
+                    bad++;
+            }
+        }
+        test_check(!bad);
+        test_check(t6963c_sim.cursor_y == scr->row && 
+                t6963c_sim.cursor_x == scr->column);
+    }
+    screen.free(scr);
+    test_check(!t6963c_sim.violations);
+}
+
+/**
+ * Draw pixels and filled rectangles and check the graphic area, pixel by
+ * pixel, after every flush
+ */
+static void test_graphics(void) {
+    static unsigned char pixels[t6963c_height][t6963c_width];
+    unsigned int i, j, x, y, w, h, on, bad, failures = test_failures;
+
+    test_setup();
+    t6963c_graphics_init();
+    memset(pixels, 0, sizeof(pixels));
+    srand(11);
+    for (i = 0; i < 300 && test_failures == failures; i++) {
+        for (j = rand() % 4; j; j--) {
+            x = rand() % t6963c_width;
+            y = rand() % t6963c_height;
+            on = rand() % 2;
+            if (rand() % 3) {
+                t6963c_pixel(x, y, on);
+                pixels[y][x] = on;
+            } else {
+                w = rand() % (t6963c_width - x) + 1;
+                h = rand() % (t6963c_height - y) + 1;
+                t6963c_fill(x, y, w, h, on);
+                for (h += y; y < h; y++)
+                    memset(&pixels[y][x], on, w);
+            }
+        }
+        t6963c_graphics_flush();
+        bad = 0;
+        for (y = 0; y < t6963c_height; y++)
+            for (x = 0; x < t6963c_width; x++)
+                if (test_pixel_at(x, y) != pixels[y][x])
+                    bad++;
+        test_check(!bad);
+    }
+    test_check(!t6963c_sim.violations);
+}
+
+#if t6963c_graphic_pages > 1
+static unsigned test_page_pixel(unsigned short home, unsigned int x,
+        unsigned int y) {
+    return (t6963c_sim.ram[(home + y * t6963c_sim.graphic_area + x / 8) %
+            t6963c_sim_ram_size] >> (7 - x % 8)) & 1;
+}
+
+/**
+ * A flush writes the page that is not shown, then shows it; the next flush
+ * brings the other page up to date with both frames
+ */
+static void test_pages(void) {
+    unsigned short front, back;
+    unsigned char page;
+
+    test_setup();
+    t6963c_graphics_init();
+    page = t6963c_page();
+    front = t6963c_sim.graphic_home;
+    back = page ? t6963c_graphic_home :
+            t6963c_graphic_home + t6963c_height * t6963c_columns;
+
+    t6963c_pixel(3, 2, 1);
+    t6963c_graphics_flush();
+    test_check(t6963c_page() == !page);
+    test_check(t6963c_sim.graphic_home == back);
+    test_check(test_page_pixel(back, 3, 2));
+    test_check(!test_page_pixel(front, 3, 2));
+
+    t6963c_pixel(9, 5, 1);
+    t6963c_graphics_flush();
+    test_check(t6963c_page() == page);
+    test_check(t6963c_sim.graphic_home == front);
+    test_check(test_page_pixel(front, 3, 2) && test_page_pixel(front, 9, 5));
+    test_check(!test_page_pixel(back, 9, 5));
+
+    t6963c_graphics_flush();
+    test_check(t6963c_page() == page);
+    test_check(!t6963c_sim.violations);
+}
+#endif
+
+static unsigned long test_now;
+
+static unsigned long test_clock(void) {
+    return test_now;
+}
+
+/**
+ * A change that has to wait for the refresh interval is written with the
+ * next update, also when that update was caused by an append
+ */
+static void test_refresh_deferred(void) {
+    T6963C_Refresh refresh;
+    Terminal* term;
+    unsigned int i;
+
+    test_setup();
+    test_now = 0;
+    t6963c_refresh_setup(&refresh, &t6963c_default, test_clock, 100, 1000);
+    term = terminal.construct(64);
+    terminal.use_attributes(term);
+    term->update = t6963c_update_terminal_scheduled;
+    term->data = &refresh;
+    terminal.append(term, "hello");
+    test_now = 10;
+    terminal.change_attributes(term, 0, 3, t6963c_attr_invert);
+    test_check(test_attribute_at(0, 0) == t6963c_attr_normal);
+    test_now = 200;
+    terminal.append(term, "x");
+    for (i = 0; i < 6; i++)
+        test_check(test_text_at(0, i) == "hellox"[i]);
+    for (i = 0; i < 6; i++)
+        test_check(test_attribute_at(0, i) == 
+                (i < 3 ? t6963c_attr_invert : t6963c_attr_normal));
+    test_check(refresh.updates == 2);
+    terminal.free(term);
+}
+
+/**
+ * Whether the LCD shows a string at a row and column
+ */
+static unsigned test_shows(unsigned int row, unsigned int column,
+        const char* string) {
+    for (; *string; string++, column++)
+        if (test_text_at(row, column) != (unsigned char) *string)
+            return 0;
+    return 1;
+}
+
+/**
+ * Windows wrap and clip their Terminals to their own cells, and leave the
+ * others alone; with t6963c_mark_window, nothing is written until
+ * t6963c_compose
+ */
+static void test_windows(void) {
+    T6963C_Window status, log;
+    T6963C_Window* windows[] = {&status, &log};
+    Terminal* background;
+    Terminal* status_term;
+    Terminal* log_term;
+    char text[t6963c_rows * t6963c_columns];
+
+    test_setup();
+    background = terminal.construct(sizeof(text));
+    background->update = t6963c_update_terminal;
+    memset(text, '#', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    terminal.append(background, text);
+    terminal.free(background);
+    
+    status_term = terminal.construct(64);
+    log_term = terminal.construct(64);
+    t6963c_window_setup(&status, &t6963c_default, 0, 0, 1, 10, status_term);
+    t6963c_window_setup(&log, &t6963c_default, 1, 5, 3, 8, log_term);
+    log.cursor = 1;
+    status_term->update = log_term->update = t6963c_update_window;
+    terminal.append(status_term, "ok");
+    terminal.append(log_term, "abcdefghij\nxy\n123");
+    test_check(test_shows(0, 0, "ok        #"));
+    test_check(test_shows(1, 4, "#ij      #"));
+    test_check(test_shows(2, 4, "#xy      #"));
+    test_check(test_shows(3, 4, "#123     #"));
+    test_check(test_shows(4, 4, "##########"));
+    test_check(t6963c_sim.cursor_y == 3 && t6963c_sim.cursor_x == 8);
+    
+    status_term->update = log_term->update = t6963c_mark_window;
+    terminal.append(status_term, "\nfail");
+    terminal.append(log_term, "4");
+    test_check(test_shows(0, 0, "ok  ") && test_shows(3, 5, "123 "));
+    t6963c_compose(windows, 2);
+    test_check(test_shows(0, 0, "fail      #"));
+    test_check(test_shows(1, 4, "#ij      #"));
+    test_check(test_shows(3, 4, "#1234    #"));
+    test_check(t6963c_sim.cursor_y == 3 && t6963c_sim.cursor_x == 9);
+    test_check(!status.stale && !log.stale);
+    
+    terminal.free(status_term);
+    terminal.free(log_term);
+    test_check(!t6963c_sim.violations);
+}
+
+#ifdef t6963c_stats
+/**
+ * The histogram bucket of a value, for a first bucket of first
+ */
+static unsigned char test_bucket(unsigned long value, unsigned long first) {
+    unsigned char i;
+    for (i = 0; i < t6963c_histogram_size - 1 && value >= first << i; i++);
+    return i;
+}
+
+/**
+ * The counters count commands, data, addresses and waits, and every update is
+ * counted in the histogram bucket of its bytes and of its time
+ */
+static void test_stats(void) {
+    T6963C_Stats stats;
+    Terminal* term;
+    char text[t6963c_rows * t6963c_columns];
+    unsigned long bytes[2], sum;
+    unsigned char i;
+
+    test_setup();
+    term = terminal.construct(1024);
+    term->update = t6963c_update_terminal;
+    t6963c_reset_stats();
+    t6963c_writeCmd2(0x24, 0, 0);
+    t6963c_writeCmd1(0xc0, 'A' - 0x20);
+    t6963c_get_stats(&stats);
+    test_check(stats.commands == 2 && stats.data == 3);
+    test_check(stats.addresses == 1 && !stats.auto_writes);
+    test_check(stats.wait_ns && !stats.updates);
+    
+    // A small update and one of the whole screen
+    t6963c_reset_stats();
+    bytes[0] = t6963c_sim.writes;
+    terminal.append(term, "a");
+    bytes[0] = t6963c_sim.writes - bytes[0];
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    bytes[1] = t6963c_sim.writes;
+    terminal.append(term, text);
+    bytes[1] = t6963c_sim.writes - bytes[1];
+    t6963c_get_stats(&stats);
+    test_check(stats.updates == 2);
+    test_check(stats.commands + stats.data == bytes[0] + bytes[1]);
+    test_check(stats.auto_writes >= 1);
+    for (i = 0, sum = 0; i < t6963c_histogram_size; i++)
+        sum += stats.update_ns[i];
+    test_check(sum == 2);
+    for (i = 0; i < t6963c_histogram_size; i++)
+        test_check(stats.update_bytes[i] == (unsigned long)
+                ((test_bucket(bytes[0], t6963c_histogram_bytes) == i) +
+                (test_bucket(bytes[1], t6963c_histogram_bytes) == i)));
+    test_check(test_bucket(bytes[0], t6963c_histogram_bytes) <
+            test_bucket(bytes[1], t6963c_histogram_bytes));
+    terminal.free(term);
+}
+#endif
+
+/**
+ * Whether a CG RAM slot holds the bitmap of a glyph
+ */
+static unsigned test_slot_holds(const unsigned char* bitmaps,
+        unsigned char slot, unsigned short glyph) {
+    unsigned int address = (t6963c_sim.offset << 11) + 0x400 + slot * 8;
+    return !memcmp(t6963c_sim.ram + address, bitmaps + glyph * 8, 8);
+}
+
+/**
+ * A glyph is uploaded to a free slot when it is first shown, is not uploaded
+ * again while it is in CG RAM, and replaces the least recently used glyph that
+ * is not on the LCD when all slots are taken
+ */
+static void test_glyphs(void) {
+    static unsigned char bitmaps[200 * 8];
+    static T6963C_Glyphs glyphs;
+    Terminal* term;
+    unsigned long writes;
+    unsigned int i;
+
+    test_setup();
+    for (i = 0; i < sizeof(bitmaps); i++)
+        bitmaps[i] = i * 37 + i / 8;
+    t6963c_set_glyphs(&glyphs, bitmaps, 200);
+    term = terminal.construct(64);
+    term->update = t6963c_update_terminal;
+    
+    // Miss: uploaded when first shown
+    terminal.append(term, "\x80\x81");
+    test_check(test_slot_holds(bitmaps, 0, 0) &&
+            test_slot_holds(bitmaps, 1, 1));
+    test_check(test_text_at(0, 0) == 0xa0 && test_text_at(0, 1) == 0xa1);
+    
+    // Hit: only the cell is written
+    writes = t6963c_sim.writes;
+    terminal.append(term, "\x81");
+    test_check(test_text_at(0, 2) == 0xa1);
+    test_check(t6963c_sim.writes - writes < 8);
+    
+    // Fill the other slots, then evict the least recently used one that is
+    // not on the LCD
+    for (i = 2; i < t6963c_cg_slots; i++)
+        test_check(t6963c_glyph(i) == 0x80 + i);
+    terminal.append(term, " ");
+    test_check(t6963c_glyph(150) == 0x82);
+    test_check(test_slot_holds(bitmaps, 2, 150));
+    test_check(test_slot_holds(bitmaps, 0, 0) &&
+            test_slot_holds(bitmaps, 3, 3));
+    test_check(t6963c_glyph(150) == 0x82);
+    
+    t6963c_set_glyphs(&glyphs, NULL, 0);
+    terminal.free(term);
+    test_check(!t6963c_sim.violations);
+}
+
+/**
+ * Record a Terminal workload, decode the trace and replay it into another
+ * simulated controller, which should then hold the same RAM
+ */
+static void test_trace(void) {
+    static unsigned char buffer[1 << 20];
+    static T6963C_Sim replay;
+    T6963C_Bus pins = t6963c_default.bus;
+    T6963C_Trace trace;
+    T6963C_Event event;
+    Terminal* term;
+    unsigned long pos, next, nspertick, events = 0, first;
+    unsigned long long start, ticks = 0;
+    unsigned int i;
+
+    t6963c_sim_init(&t6963c_sim);
+    t6963c_trace_setup(&trace, &pins, buffer, sizeof(buffer), NULL);
+    t6963c_default.bus = trace.bus;
+    t6963c_init();
+    term = terminal.construct(256);
+    terminal.use_attributes(term);
+    term->update = t6963c_update_terminal;
+    for (i = 0; i < 40; i++) {
+        terminal.set_attribute(term, i % 3 ? t6963c_attr_normal : 
+                t6963c_attr_invert);
+        terminal.format(term, "line %u\n", i);
+    }
+    terminal.free(term);
+    t6963c_default.bus = pins;
+    test_check(!trace.dropped);
+
+    first = pos = t6963c_trace_header(buffer, trace.length, &nspertick);
+    test_check(pos && nspertick == t6963c_nspertick);
+    t6963c_sim_init(&replay);
+    start = t6963c_sim_ns;
+    for (; pos < trace.length && (next = t6963c_trace_next(buffer, 
+            trace.length, pos, &event)); pos = next) {
+        events++;
+        ticks += event.ticks;
+        t6963c_sim_ns = start + ticks * nspertick;
+        if (event.kind == t6963c_event_reset)
+            t6963c_sim_bus_reset(&replay);
+        else if (event.kind != t6963c_event_status)
+            t6963c_sim_write(&replay, event.kind == t6963c_event_command,
+                    event.byte);
+    }
+    test_check(pos == trace.length);
+    test_check(events == t6963c_sim.writes + t6963c_sim.reads + 1);
+    test_check(trace.length - first <= 3 * events);
+    test_check(replay.writes == t6963c_sim.writes);
+    test_check(!memcmp(replay.ram, t6963c_sim.ram, sizeof(replay.ram)));
+    test_check(!replay.violations && !t6963c_sim.violations);
+}
+
+static unsigned long test_block_commands, test_block_runs;
+
+static void test_block_command(void* sim, unsigned char cmd, unsigned char n,
+        unsigned char data1, unsigned char data2) {
+    test_block_commands++;
+    t6963c_sim_bus_command(sim, cmd, n, data1, data2);
+}
+
+static void test_block_run(void* sim, const unsigned char* bytes,
+        unsigned short n) {
+    test_block_runs++;
+    t6963c_sim_bus_run(sim, bytes, n);
+}
+
+/**
+ * Text with attributes, then graphics
+ */
+static void test_block_workload(void) {
+    Terminal* term;
+    unsigned int i;
+
+    t6963c_init();
+    term = terminal.construct(256);
+    terminal.use_attributes(term);
+    term->update = t6963c_update_terminal;
+    for (i = 0; i < 40; i++) {
+        terminal.set_attribute(term, i % 3 ? t6963c_attr_normal :
+                t6963c_attr_invert);
+        terminal.format(term, "line %u\n", i);
+    }
+    terminal.free(term);
+    t6963c_graphics_init();
+    srand(13);
+    for (i = 0; i < 50; i++) {
+        t6963c_fill(rand() % t6963c_width, rand() % t6963c_height,
+                rand() % 40 + 1, rand() % 10 + 1, rand() % 2);
+        t6963c_pixel(rand() % t6963c_width, rand() % t6963c_height, 1);
+        t6963c_graphics_flush();
+    }
+    t6963c_display_wait(&t6963c_default);
+}
+
+/**
+ * The same workload through the pins and through the block functions of the
+ * bus leaves the same RAM and registers in the controller
+ */
+static void test_block(void) {
+    static T6963C_Sim block;
+    T6963C_Bus pins = t6963c_default.bus;
+    T6963C_Bus bus = {t6963c_sim_bus_write, t6963c_sim_bus_status,
+            t6963c_sim_bus_reset, &block, test_block_command, test_block_run};
+
+    t6963c_sim_init(&t6963c_sim);
+    test_block_workload();
+
+    t6963c_sim_init(&block);
+    test_block_commands = test_block_runs = 0;
+    t6963c_default.bus = bus;
+    test_block_workload();
+    t6963c_default.bus = pins;
+    test_check(test_block_commands && test_block_runs);
+    test_check(!memcmp(block.ram, t6963c_sim.ram, sizeof(block.ram)));
+    test_check(block.text_home == t6963c_sim.text_home &&
+            block.graphic_home == t6963c_sim.graphic_home &&
+            block.mode == t6963c_sim.mode &&
+            block.display == t6963c_sim.display);
+    test_check(block.cursor_x == t6963c_sim.cursor_x &&
+            block.cursor_y == t6963c_sim.cursor_y);
+    test_check(!block.violations && !t6963c_sim.violations);
+}
+
+/**
+ * Every wait takes at least as long as requested, also when that is less than
+ * a tick or not a whole number of ticks
+ */
+static void test_wait_at_rate(void) {
+    static const unsigned long ns[] = {
+        0, 1, t6963c_nspertick - 1, t6963c_nspertick, t6963c_nspertick + 1,
+        t6963c_tdh_ns, t6963c_tce_ns, t6963c_tas_ns, t6963c_status_ns,
+        t6963c_auto_ns, t6963c_cmd_ns, 65535, 65536, t6963c_auto_mode_ns,
+        10 * t6963c_cmd_ns
+    };
+    unsigned long long start;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(ns) / sizeof(ns[0]); i++) {
+        start = t6963c_sim_ns;
+        t6963c_wait_ns(ns[i]);
+        test_check(t6963c_sim_ns - start >= ns[i]);
+    }
+    // The waits with compile-time constants
+    start = t6963c_sim_ns;
+    t6963c_wait(t6963c_tce_ns);
+    test_check(t6963c_sim_ns - start >= t6963c_tce_ns);
+    start = t6963c_sim_ns;
+    t6963c_wait(t6963c_auto_mode_ns);
+    test_check(t6963c_sim_ns - start >= t6963c_auto_mode_ns);
+}
+
+/**
+ * Every wait takes at least as long as requested, also when that is less than
+ * a tick or not a whole number of ticks, and when the timer is read more or
+ * less often than it ticks
+ */
+static void test_wait(void) {
+    static const unsigned long read_ns[] = {
+        t6963c_nspertick, 1, t6963c_nspertick / 3 + 1, 3 * t6963c_nspertick + 1
+    };
+    unsigned int i;
+    for (i = 0; i < sizeof(read_ns) / sizeof(read_ns[0]); i++) {
+        t6963c_sim_read_ns = read_ns[i];
+        test_wait_at_rate();
+    }
+    t6963c_sim_read_ns = t6963c_nspertick;
+}
+
+/**
+ * Plan and run the spans, and check that the RAM holds data where they are
+ */
+static void test_plan_run(T6963C_Plan* plan, const T6963C_Span* spans,
+        unsigned char n) {
+    static unsigned char data[256];
+    unsigned int i, bad = 0;
+    unsigned char j;
+    test_setup();
+    for (i = 0; i < sizeof(data); i++)
+        data[i] = i ^ 0x5a;
+    t6963c_plan(plan, spans, n, 0x1000);
+    t6963c_plan_run(plan, data, 0);
+    for (j = 0; j < n; j++)
+        for (i = spans[j].address; i < spans[j].address + spans[j].length; i++)
+            if (t6963c_sim.ram[i] != data[i])
+                bad++;
+    test_check(!bad);
+    test_check(!t6963c_sim.violations);
+}
+
+/**
+ * A single cell is a data write, a long run an auto write run, and a short gap
+ * is written over instead of setting a new address
+ */
+static void test_plan(void) {
+    static const T6963C_Span single[] = {{10, 1, 0}};
+    static const T6963C_Span run[] = {{0, 200, 0}};
+    static const T6963C_Span gapped[] = {{20, 30, 0}, {52, 30, 0}};
+    T6963C_Plan plan;
+    
+    test_plan_run(&plan, single, 1);
+    test_check(plan.length == 1 && plan.steps[0].type == t6963c_step_write);
+    test_check(plan.steps[0].set_address && plan.steps[0].address == 10);
+    test_check(plan.steps[0].length == 1);
+    
+    test_plan_run(&plan, run, 1);
+    test_check(plan.length == 1 && plan.steps[0].type == t6963c_step_auto);
+    test_check(plan.steps[0].length == 200);
+    
+    test_plan_run(&plan, gapped, 2);
+    test_check(plan.length == 1 && plan.steps[0].type == t6963c_step_auto);
+    test_check(plan.steps[0].address == 20 && plan.steps[0].length == 62);
+}
+
+/**
+ * Queue a Terminal, a command and a run, and drain the queue with ticks
+ */
+static void test_queue(void) {
+    static const char run[] = {'B' - 0x20, 'C' - 0x20};
+    unsigned short address;
+    unsigned int sync, cmd, ticks;
+    Terminal* term;
+    
+    test_setup();
+    term = terminal.construct(64);
+    terminal.append(term, "hi");
+    sync = t6963c_queue_terminal(term);
+    address = t6963c_sim.text_home + t6963c_sim.text_area;
+    test_check(t6963c_queue_cmd(0x24, 2, address & 0xff, address >> 8));
+    cmd = t6963c_queue_cmd(0xc0, 1, 'A' - 0x20, 0);
+    test_check(t6963c_queue_run(address + 1, run, 2));
+    test_check(sync && cmd && t6963c_queue_depth() == 4);
+    test_check(!t6963c_queue_done(sync));
+    for (ticks = 0; ticks < 10000 && t6963c_queue_depth(); ticks++) {
+        t6963c_sim_ns += 5000;
+        t6963c_queue_tick(5000);
+    }
+    test_check(!t6963c_queue_depth());
+    test_check(t6963c_queue_done(sync) && t6963c_queue_done(cmd));
+    test_check(test_text_at(0, 0) == 'h' && test_text_at(0, 1) == 'i');
+    test_check(test_text_at(1, 0) == 'A' && test_text_at(1, 1) == 'B' &&
+            test_text_at(1, 2) == 'C');
+    test_check(!t6963c_sim.violations);
+    terminal.free(term);
+}
+
+int main(void) {
+    test_terminal();
+    test_screen();
+    test_graphics();
+    test_refresh_deferred();
+    test_queue();
+    test_plan();
+    test_wait();
+    test_trace();
+    test_block();
+    test_glyphs();
+    test_windows();
+#if t6963c_graphic_pages > 1
+    test_pages();
+#endif
+#ifdef t6963c_stats
+    test_stats();
+#endif
+    if (test_failures)
+        printf("%u checks failed\n", test_failures);
+    return test_failures > 255 ? 255 : test_failures;
+}
@@ -0,0 +1,185 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "t6963c_trace.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * Encode a varint
+ * @return the number of bytes
+ */
+static unsigned t6963c_trace_varint(unsigned char* out,
+        unsigned long long value) {
+    unsigned n = 0;
+    do {
+        out[n] = value & 0x7f;
+        value >>= 7;
+        if (value)
+            out[n] |= 0x80;
+        n++;
+    } while (value);
+    return n;
+}
+
+static unsigned long t6963c_trace_now(T6963C_Trace* trace) {
+    return trace->clock ? trace->clock() : t6963c_timestamp();
+}
+
+static void t6963c_trace_record_at(T6963C_Trace* trace, unsigned char kind,
+        unsigned char byte, unsigned long now) {
+    unsigned char event[12];
+    unsigned n;
+
+    if (trace->dropped) {
+        trace->dropped++;
+        return;
+    }
+    n = t6963c_trace_varint(event, 
+            ((unsigned long long) (now - trace->last) << 2) | kind);
+    if (kind != t6963c_event_reset)
+        event[n++] = byte;
+    if (trace->length + n > trace->size) {
+        trace->dropped++;
+        return;
+    }
+    memcpy(trace->buffer + trace->length, event, n);
+    trace->length += n;
+    trace->last = now;
+}
+
+static void t6963c_trace_record(T6963C_Trace* trace, unsigned char kind,
+        unsigned char byte) {
+    t6963c_trace_record_at(trace, kind, byte, t6963c_trace_now(trace));
+}
+
+void t6963c_trace_setup(T6963C_Trace* trace, const T6963C_Bus* target,
+        unsigned char* buffer, unsigned long size,
+        unsigned long (*clock)(void)) {
+    trace->target = *target;
+    trace->bus.write = t6963c_trace_write;
+    trace->bus.status = target->status ? t6963c_trace_status : NULL;
+    trace->bus.reset = t6963c_trace_reset;
+    trace->bus.data = trace;
+    trace->bus.command = target->command ? t6963c_trace_command : NULL;
+    trace->bus.run = target->run ? t6963c_trace_run : NULL;
+    trace->clock = clock;
+    trace->buffer = buffer;
+    trace->size = size;
+    trace->dropped = 0;
+    trace->last = t6963c_trace_now(trace);
+
+    memcpy(buffer, "T6T", 3);
+    buffer[3] = t6963c_trace_version;
+    trace->length = 4 + t6963c_trace_varint(buffer + 4, t6963c_nspertick);
+}
+
+void t6963c_trace_write(void* data, unsigned cd, unsigned char byte) {
+    T6963C_Trace* trace = (T6963C_Trace*) data;
+    t6963c_trace_record(trace, 
+            cd ? t6963c_event_command : t6963c_event_data, byte);
+    trace->target.write(trace->target.data, cd, byte);
+}
+
+unsigned char t6963c_trace_status(void* data) {
+    T6963C_Trace* trace = (T6963C_Trace*) data;
+    unsigned char status = trace->target.status(trace->target.data);
+    t6963c_trace_record(trace, t6963c_event_status, status);
+    return status;
+}
+
+void t6963c_trace_reset(void* data) {
+    T6963C_Trace* trace = (T6963C_Trace*) data;
+    t6963c_trace_record(trace, t6963c_event_reset, 0);
+    trace->target.reset(trace->target.data);
+}
+
+void t6963c_trace_command(void* data, unsigned char cmd, unsigned char n,
+        unsigned char data1, unsigned char data2) {
+    T6963C_Trace* trace = (T6963C_Trace*) data;
+    if (n > 0)
+        t6963c_trace_record(trace, t6963c_event_data, data1);
+    if (n > 1)
+        t6963c_trace_record(trace, t6963c_event_data, data2);
+    t6963c_trace_record(trace, t6963c_event_command, cmd);
+    trace->target.command(trace->target.data, cmd, n, data1, data2);
+}
+
+/**
+ * The time at which each byte of a run was written is not known; the bytes are
+ * spread evenly over the time the run took, which is never sooner than they
+ * were written.
+ */
+void t6963c_trace_run(void* data, const unsigned char* bytes,
+        unsigned short n) {
+    T6963C_Trace* trace = (T6963C_Trace*) data;
+    unsigned long start = t6963c_trace_now(trace), time;
+    unsigned short i;
+    trace->target.run(trace->target.data, bytes, n);
+    time = t6963c_trace_now(trace) - start;
+    for (i = 0; i < n; i++)
+        t6963c_trace_record_at(trace, t6963c_event_data, bytes[i], start + 
+                (n > 1 ? (unsigned long long) time * i / (n - 1) : 0));
+}
+
+/**
+ * Decode a varint
+ * @return the position after it, or 0 if it is incomplete or too long
+ */
+static unsigned long t6963c_trace_unvarint(const unsigned char* trace,
+        unsigned long length, unsigned long pos, unsigned long long* value) {
+    unsigned shift = 0;
+    *value = 0;
+    do {
+        if (pos >= length || shift > 63)
+            return 0;
+        *value |= (unsigned long long) (trace[pos] & 0x7f) << shift;
+        shift += 7;
+    } while (trace[pos++] & 0x80);
+    return pos;
+}
+
+unsigned long t6963c_trace_header(const unsigned char* trace,
+        unsigned long length, unsigned long* nspertick) {
+    unsigned long long value;
+    unsigned long pos;
+    if (length < 5 || memcmp(trace, "T6T", 3) || 
+            trace[3] != t6963c_trace_version)
+        return 0;
+    if (!(pos = t6963c_trace_unvarint(trace, length, 4, &value)))
+        return 0;
+    *nspertick = value;
+    return pos;
+}
+
+unsigned long t6963c_trace_next(const unsigned char* trace,
+        unsigned long length, unsigned long pos, T6963C_Event* event) {
+    unsigned long long value;
+    if (!(pos = t6963c_trace_unvarint(trace, length, pos, &value)))
+        return 0;
+    event->kind = value & 0x03;
+    event->ticks = value >> 2;
+    event->byte = 0;
+    if (event->kind != t6963c_event_reset) {
+        if (pos >= length)
+            return 0;
+        event->byte = trace[pos++];
+    }
+    return pos;
+}
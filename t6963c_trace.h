@@ -0,0 +1,127 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   t6963c_trace.h
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Recording of the bytes sent to an LCD. A T6963C_Trace is a bus backend that
+ * passes everything on to another backend, and records every event in a
+ * buffer: a written command or data byte, a status read or a reset. The trace
+ * can be copied off the device and replayed with t6963c_replay.c on a host.
+ *
+ * The format is compact. After a header of the magic bytes "T6T", the version
+ * and the length of a tick in ns (as a varint), every event is:
+ *
+ *  - a varint of the time since the previous event in ticks, shifted left by
+ *    two, with the kind of event (t6963c_event_*) in the lowest two bits;
+ *  - the byte written or read, except for a reset.
+ *
+ * A varint holds 7 bits per byte, least significant first; the highest bit is
+ * set in all bytes but the last. The time takes one byte when the event comes
+ * within 31 ticks of the previous one, which is rare when the driver waits for
+ * the LCD after every byte, so most events take three bytes.
+ */
+
+#ifndef T6963C_TRACE_H
+#define	T6963C_TRACE_H
+
+#include "t6963c.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define t6963c_trace_version 1
+
+// Kinds of events
+#define t6963c_event_data 0     // data byte written
+#define t6963c_event_command 1  // command byte written
+#define t6963c_event_status 2   // status read
+#define t6963c_event_reset 3    // reset, without byte
+
+typedef struct T6963C_Trace {
+    T6963C_Bus bus;             // the recording backend, for the display
+    T6963C_Bus target;          // the backend that is recorded
+    unsigned long (*clock)(void);       // free-running clock, or NULL for
+                                        // t6963c_timestamp()
+    unsigned char* buffer;
+    unsigned long size;         // size of the buffer
+    unsigned long length;       // bytes recorded
+    unsigned long last;         // time of the last event
+    unsigned long dropped;      // events that did not fit
+} T6963C_Trace;
+
+/**
+ * An event decoded from a trace
+ */
+typedef struct T6963C_Event {
+    unsigned char kind;         // t6963c_event_*
+    unsigned char byte;
+    unsigned long long ticks;   // time since the previous event
+} T6963C_Event;
+
+/**
+ * Set up the recording of a backend, and write the header of the trace.
+ * Connect a display to the bus of the T6963C_Trace to record it. Once the
+ * buffer is full, recording stops, so that the trace holds the first events
+ * only; the others are counted in dropped.
+ * @param target the backend to record; its command and run are used when it
+ *   has them
+ * @param buffer at least 16 bytes
+ * @param clock the clock for the timestamps, counting in ticks of
+ *   t6963c_nspertick ns, or NULL for t6963c_timestamp()
+ */
+void t6963c_trace_setup(T6963C_Trace*, const T6963C_Bus* target,
+        unsigned char* buffer, unsigned long size,
+        unsigned long (*clock)(void));
+
+/**
+ * Bus functions of the recording backend, with a T6963C_Trace* as data
+ */
+void t6963c_trace_write(void* trace, unsigned cd, unsigned char byte);
+unsigned char t6963c_trace_status(void* trace);
+void t6963c_trace_reset(void* trace);
+void t6963c_trace_command(void* trace, unsigned char cmd, unsigned char n,
+        unsigned char data1, unsigned char data2);
+void t6963c_trace_run(void* trace, const unsigned char* bytes,
+        unsigned short n);
+
+/**
+ * Read the header of a trace
+ * @param nspertick is set to the length of a tick in ns
+ * @return the position of the first event, or 0 if this is not a trace of a
+ *   known version
+ */
+unsigned long t6963c_trace_header(const unsigned char* trace,
+        unsigned long length, unsigned long* nspertick);
+
+/**
+ * Decode the event at position pos of a trace
+ * @return the position of the next event, or 0 at the end of the trace or
+ *   when the last event is incomplete
+ */
+unsigned long t6963c_trace_next(const unsigned char* trace,
+        unsigned long length, unsigned long pos, T6963C_Event*);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* T6963C_TRACE_H */
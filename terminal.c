@@ -18,75 +18,460 @@
  */
 
 #include "terminal.h"
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Flags of a conversion of format
+#define terminal_left 0x01              // '-': pad on the right
+#define terminal_zero 0x02              // '0': pad numbers with zeroes
+
+#if terminal_pool_size
+static Terminal terminal_pool[terminal_pool_size];
+static char terminal_pool_content[terminal_pool_size][terminal_pool_length + 1];
+#if terminal_pool_attributes
+static unsigned char terminal_pool_attr[terminal_pool_size][terminal_pool_length + 1];
+#define terminal_pool_attributes_of(i) terminal_pool_attr[i]
+#else
+#define terminal_pool_attributes_of(i) NULL
+#endif
+#endif
+
+/**
+ * All Terminals, so that the functions that take a string can find the
+ * Terminal of which it is the content
+ */
+static Terminal* terminal_list;
+
+static void terminal_enlist(Terminal* terminal) {
+    terminal->next = terminal_list;
+    terminal_list = terminal;
+}
+
+static void terminal_delist(Terminal* terminal) {
+    Terminal** link;
+    for (link = &terminal_list; *link; link = &(*link)->next) {
+        if (*link == terminal) {
+            *link = terminal->next;
+            return;
+        }
+    }
+}
+
+/**
+ * The Terminal of which a string is the content, or NULL
+ */
+static Terminal* terminal_of(char* string) {
+    Terminal* terminal;
+    for (terminal = terminal_list; terminal; terminal = terminal->next)
+        if (terminal->content == string)
+            return terminal;
+    return NULL;
+}
+
 static Terminal* terminal_construct(unsigned int length) {
     char* content = calloc(1, length + 1);
     Terminal* terminal = calloc(1, sizeof(Terminal));
-    if (content == NULL || terminal == NULL)
+    if (content == NULL || terminal == NULL) {
+        free(content);
+        free(terminal);
         return NULL;
+    }
     
     terminal->content = content;
     terminal->length = length;
     terminal->update = NULL;
+    terminal->data = NULL;
+    terminal->attributes = NULL;
+    terminal_enlist(terminal);
     
     return terminal;
 }
 
-static void terminal_free(Terminal* terminal) {
-    free(terminal->content);
-    free(terminal);
+static Terminal* terminal_construct_ring(unsigned int length) {
+    Terminal* terminal = terminal_construct(length);
+    if (terminal != NULL) {
+        terminal->ring = 1;
+        terminal->overflow = terminal_overflow_drop;
+    }
+    return terminal;
 }
 
-static unsigned terminal_append_n(
-		Terminal* terminal, char* string, unsigned short n) {
-    if (strlen(terminal->content) + n > terminal->length) {
-        unsigned int length = terminal->length + n * 2;
-        terminal->content = realloc(terminal->content, length + 1);
-        if (terminal->content == NULL)
-            return 0;
-        terminal->length = length;
+static Terminal* terminal_init(Terminal* terminal, char* content,
+        unsigned char* attributes, unsigned int length, unsigned char overflow) {
+    terminal_delist(terminal);
+    memset(terminal, 0, sizeof(Terminal));
+    content[0] = '\0';
+    terminal->content = content;
+    terminal->attributes = attributes;
+    terminal->length = length;
+    terminal->fixed = 1;
+    terminal->overflow = overflow == terminal_overflow_grow ? 
+            terminal_overflow_reject : overflow;
+    terminal->ring = overflow == terminal_overflow_drop;
+    terminal_enlist(terminal);
+    return terminal;
+}
+
+static Terminal* terminal_take(unsigned char overflow) {
+#if terminal_pool_size
+    unsigned char i;
+    for (i = 0; i < terminal_pool_size; i++)
+        if (terminal_pool[i].content == NULL)
+            return terminal_init(terminal_pool + i, terminal_pool_content[i],
+                    terminal_pool_attributes_of(i), terminal_pool_length,
+                    overflow);
+#else
+    (void) overflow;
+#endif
+    return NULL;
+}
+
+static void terminal_free(Terminal* terminal) {
+    terminal_delist(terminal);
+    if (terminal->index_allocated)
+        free(terminal->index);
+    if (terminal->attributes_allocated)
+        free(terminal->attributes);
+    if (!terminal->fixed) {
+        free(terminal->content);
+        free(terminal);
+    } else {
+        terminal->content = NULL;       // returns a pool Terminal to the pool
     }
-    strncat(terminal->content, string, n);
+}
+
+static unsigned int terminal_size(Terminal* terminal) {
+    return terminal->used;
+}
+
+static char terminal_char_at(Terminal* terminal, unsigned int i) {
+    i += terminal->start;
+    if (i >= terminal->length)
+        i -= terminal->length;
+    return terminal->content[i];
+}
+
+/**
+ * Record that the data changed from a position on
+ */
+static void terminal_mark(Terminal* terminal, unsigned long from) {
+    if (!terminal->change.changed || from < terminal->change.from)
+        terminal->change.from = from;
+    terminal->change.changed = 1;
+}
+
+static void terminal_flush(Terminal* terminal) {
+    if (!terminal->change.changed)
+        return;
     if (terminal->update)
         terminal->update(terminal);
+    memset(&terminal->change, 0, sizeof(TerminalChange));
+}
+
+/**
+ * Call the update callback, unless in a batch
+ */
+static void terminal_changed(Terminal* terminal) {
+    if (!terminal->batches)
+        terminal_flush(terminal);
+}
+
+static void terminal_begin(Terminal* terminal) {
+    terminal->batches++;
+}
+
+static void terminal_end(Terminal* terminal) {
+    if (terminal->batches && !--terminal->batches)
+        terminal_flush(terminal);
+}
+
+static unsigned long terminal_index_at(Terminal* terminal, unsigned int i) {
+    return terminal->index[(terminal->index_first + i) % terminal->index_length];
+}
+
+static void terminal_index_push(Terminal* terminal, unsigned long start) {
+    if (terminal->index_used == terminal->index_length) {
+        terminal->index_first = (terminal->index_first + 1) % terminal->index_length;
+        terminal->index_used--;
+    }
+    terminal->index[(terminal->index_first + terminal->index_used) % 
+            terminal->index_length] = start;
+    terminal->index_used++;
+    if (terminal->line_count)
+        terminal->line_count++;
+}
+
+/**
+ * Add the line starts in n characters that are appended at the end of the
+ * data to the index.
+ */
+static void terminal_index_append(Terminal* terminal, char* string, unsigned int n) {
+    unsigned long position = terminal->base + terminal->used;
+    unsigned int i;
+    if (!terminal->row_length)
+        return;
+    for (i = 0; i < n; i++) {
+        if (string[i] == '\n' || terminal->column == terminal->row_length - 1) {
+            terminal_index_push(terminal, position + i + 1);
+            terminal->column = 0;
+        } else {
+            terminal->column++;
+        }
+    }
+}
+
+/**
+ * Rebuild the index by scanning the data
+ */
+static void terminal_index_rebuild(Terminal* terminal) {
+    unsigned int i;
+    terminal->index_first = 0;
+    terminal->index_used = 0;
+    terminal->line_count = 1;
+    terminal->column = 0;
+    for (i = 0; i < terminal->used; i++) {
+        if (terminal_char_at(terminal, i) == '\n' ||
+                terminal->column == terminal->row_length - 1) {
+            terminal_index_push(terminal, terminal->base + i + 1);
+            terminal->column = 0;
+        } else {
+            terminal->column++;
+        }
+    }
+}
+
+/**
+ * Remove the line starts after the end of the data from the index
+ */
+static void terminal_index_discard(Terminal* terminal) {
+    unsigned long end = terminal->base + terminal->used;
+    if (!terminal->row_length)
+        return;
+    while (terminal->index_used && 
+            terminal_index_at(terminal, terminal->index_used - 1) > end) {
+        terminal->index_used--;
+        if (terminal->line_count)
+            terminal->line_count--;
+    }
+    if (terminal->index_used)
+        terminal->column = end - terminal_index_at(terminal, terminal->index_used - 1);
+    else if (terminal->line_count == 1)
+        terminal->column = terminal->used;
+    else
+        terminal_index_rebuild(terminal);
+}
+
+/**
+ * The first slot of the index with a line start at or after a position, or
+ * index_used if there is none. The line starts are sorted.
+ */
+static unsigned int terminal_index_find(Terminal* terminal, unsigned long position) {
+    unsigned int low = 0, high = terminal->index_used, middle;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (terminal_index_at(terminal, middle) < position)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+/**
+ * Remove the line starts before the start of the data from the index. When
+ * the data no longer starts at a line start, the rows after it wrap at other
+ * places, so the index is rebuilt.
+ * @param lines the number of lines that were dropped if the data is known to
+ *   start at a line start, 0 otherwise
+ */
+static void terminal_index_drop(Terminal* terminal, unsigned int lines) {
+    unsigned long last = 0;
+    unsigned int i;
+    if (!terminal->row_length)
+        return;
+    i = terminal_index_find(terminal, terminal->base + 1);
+    if (i) {
+        last = terminal_index_at(terminal, i - 1);
+        terminal->index_first = (terminal->index_first + i) % terminal->index_length;
+        terminal->index_used -= i;
+    }
+    if (last == terminal->base)
+        terminal->line_count = terminal->index_used + 1;
+    else if (lines && terminal->line_count > lines)
+        terminal->line_count -= lines;
+    else
+        terminal_index_rebuild(terminal);
+}
+
+/**
+ * Drop the first n characters
+ * @param lines as for terminal_index_drop
+ */
+static void terminal_drop_lines(Terminal* terminal, unsigned int n,
+        unsigned int lines) {
+    if (n > terminal->used)
+        n = terminal->used;
+    if (!n)
+        return;
+    terminal->used -= n;
+    if (terminal->ring) {
+        terminal->start += n;
+        if (terminal->start >= terminal->length)
+            terminal->start -= terminal->length;
+    } else {
+        memmove(terminal->content, terminal->content + n, terminal->used + 1);
+        if (terminal->attributes)
+            memmove(terminal->attributes, terminal->attributes + n,
+                    terminal->used);
+    }
+    terminal->base += n;
+    terminal->change.dropped += n;
+    terminal_index_drop(terminal, lines);
+}
+
+static void terminal_drop(Terminal* terminal, unsigned int n) {
+    terminal_drop_lines(terminal, n, 0);
+}
+
+/**
+ * Drop the oldest characters, so that n more fit. With an index, whole lines
+ * are dropped.
+ */
+static void terminal_make_room(Terminal* terminal, unsigned int n) {
+    if (terminal->used + n > terminal->length) {
+        unsigned long end = terminal->base + terminal->used + n - terminal->length;
+        unsigned int i = terminal_index_find(terminal, end);
+        if (i < terminal->index_used && 
+                terminal_index_at(terminal, i) <= terminal->base + terminal->used)
+            end = terminal_index_at(terminal, i);
+        terminal_drop(terminal, end - terminal->base);
+    }
+}
+
+/**
+ * Reallocate the content of a Terminal that is not circular, and the
+ * attributes if it has them. On failure, the old blocks are kept.
+ * @return 0 if allocating memory failed, 1 otherwise
+ */
+static unsigned terminal_grow(Terminal* terminal, unsigned int length) {
+    char* content;
+    unsigned char* attributes;
+    if (terminal->fixed || 
+            (terminal->attributes && !terminal->attributes_allocated))
+        return 0;
+    content = realloc(terminal->content, length + 1);
+    if (content == NULL)
+        return 0;
+    terminal->content = content;
+    if (terminal->attributes) {
+        attributes = realloc(terminal->attributes, length + 1);
+        if (attributes == NULL)
+            return 0;
+        terminal->attributes = attributes;
+    }
+    terminal->length = length;
     return 1;
 }
 
+/**
+ * Make room for n more characters, following the overflow policy
+ * @return how many of the n characters may be appended. With
+ *   terminal_overflow_drop, these are the last ones.
+ */
+static unsigned int terminal_room(Terminal* terminal, unsigned int n) {
+    if (terminal->used + n <= terminal->length)
+        return n;
+    switch (terminal->overflow) {
+        case terminal_overflow_grow:
+            return terminal_grow(terminal, terminal->length * 2 + n) ? n : 0;
+        case terminal_overflow_drop:
+            if (n > terminal->length)
+                n = terminal->length;
+            terminal_make_room(terminal, n);
+            return n;
+        case terminal_overflow_truncate:
+            return terminal->length - terminal->used;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Copy n characters to the end of the data, for which there must be room. In
+ * a circular buffer, they may wrap around.
+ */
+static void terminal_write(Terminal* terminal, char* string, unsigned int n) {
+    unsigned int end, first;
+    terminal_mark(terminal, terminal->base + terminal->used);
+    terminal->change.appended += n;
+    terminal_index_append(terminal, string, n);
+    end = terminal->start + terminal->used;
+    if (end >= terminal->length)
+        end -= terminal->length;
+    first = terminal->length - end;
+    if (first > n)
+        first = n;
+    memcpy(terminal->content + end, string, first);
+    memcpy(terminal->content, string + first, n - first);
+    if (terminal->attributes) {
+        memset(terminal->attributes + end, terminal->attribute, first);
+        memset(terminal->attributes, terminal->attribute, n - first);
+    }
+    terminal->used += n;
+    if (!terminal->ring)
+        terminal->content[terminal->used] = '\0';
+}
+
+static unsigned terminal_append_n(
+		Terminal* terminal, char* string, unsigned short n) {
+    unsigned short i, room;
+    for (i = 0; i < n && string[i]; i++);
+    n = i;
+    
+    room = terminal_room(terminal, n);
+    if (terminal->overflow == terminal_overflow_drop)
+        string += n - room;
+    if (room) {
+        terminal_write(terminal, string, room);
+        terminal_changed(terminal);
+    }
+    return room == n;
+}
+
 static unsigned terminal_append(Terminal* terminal, char* string) {
 	return terminal_append_n(terminal, string, strlen(string));
 }
 
 static unsigned terminal_appendChar(Terminal* terminal, char character) {
-    if (strlen(terminal->content) + 1 > terminal->length) {
-        unsigned int length = terminal->length * 2;
-        terminal->content = realloc(terminal->content, length + 1);
-        if (terminal->content == NULL)
-            return 0;
-        terminal->length = length;
-    }
-    unsigned int length = strlen(terminal->content);
-    terminal->content[length] = character;
-    terminal->content[length + 1] = NULL;
-    if (terminal->update)
-        terminal->update(terminal);
+    if (!terminal_room(terminal, 1))
+        return 0;
+    terminal_write(terminal, &character, 1);
+    terminal_changed(terminal);
     return 1;
 } 
 
 static void terminal_discard(Terminal* terminal, unsigned int n) {
-	unsigned int len;
-	len = strlen(terminal->content);
-	if (len < n)
-		n = len;
-    *(terminal->content + strlen(terminal->content) - n) = NULL;
-    if (terminal->update)
-        terminal->update(terminal);
+	if (terminal->used < n)
+		n = terminal->used;
+    terminal->used -= n;
+    terminal_mark(terminal, terminal->base + terminal->used);
+    terminal->change.discarded += n;
+    if (!terminal->ring)
+        terminal->content[terminal->used] = '\0';
+    terminal_index_discard(terminal);
+    terminal_changed(terminal);
 }
 
+static unsigned int terminal_lines(Terminal*, unsigned int row_length);
+static void terminal_drop_first_line(Terminal*, unsigned int row_length);
+
 static unsigned int terminal_lines_needed(char* string, unsigned int row_length) {
+    Terminal* terminal = terminal_of(string);
     unsigned int i;
     unsigned int lines = 1, current_line = 0;
+    if (terminal)
+        return terminal_lines(terminal, row_length);
     for (i=0; string[i]; i++) {
         if (string[i] == '\n') {
             current_line = 0;
@@ -102,11 +487,391 @@ static unsigned int terminal_lines_needed(char* string, unsigned int row_length)
 }
 
 static void terminal_discard_first_line(char* string, unsigned int row_length) {
+    Terminal* terminal = terminal_of(string);
     unsigned int i;
+    if (terminal) {
+        terminal_drop_first_line(terminal, row_length);
+        return;
+    }
     for (i = 0; string[i] && string[i] != '\n' && i < row_length - 1; i++);
     strcpy(string, string + i + 1);
 }
 
+static unsigned int terminal_lines(Terminal* terminal, unsigned int row_length) {
+    unsigned int i;
+    if (row_length == terminal->row_length) {
+        if (!terminal->line_count)
+            terminal_index_rebuild(terminal);
+        return terminal->line_count;
+    }
+    unsigned int lines = 1, current_line = 0;
+    for (i = 0; i < terminal->used; i++) {
+        if (terminal_char_at(terminal, i) == '\n') {
+            current_line = 0;
+            lines++;
+        } else if (current_line == row_length - 1) {
+            current_line = 0;
+            lines++;
+        } else {
+            current_line++;
+        }
+    }
+    return lines;
+}
+
+static void terminal_drop_first_line(Terminal* terminal, unsigned int row_length) {
+    unsigned int i;
+    if (row_length == terminal->row_length) {
+        if (!terminal->line_count)
+            terminal_index_rebuild(terminal);
+        if (terminal->line_count == 1) {
+            terminal_drop(terminal, terminal->used);
+            return;
+        }
+        if (terminal->line_count == terminal->index_used + 1) {
+            terminal_drop(terminal, 
+                    terminal_index_at(terminal, 0) - terminal->base);
+            return;
+        }
+    }
+    for (i = 0; i < terminal->used && 
+            terminal_char_at(terminal, i) != '\n' && i < row_length - 1; i++);
+    terminal_drop_lines(terminal, i + 1, row_length == terminal->row_length);
+}
+
+static unsigned terminal_index_lines(Terminal* terminal, 
+        unsigned int row_length, unsigned long* storage, unsigned int size) {
+    Terminal* other;
+    if (size == 0)
+        return 0;
+    if (storage == NULL) {
+        if (terminal->fixed)
+            return 0;
+        if (!terminal->index_allocated)
+            terminal->index = NULL;
+        storage = realloc(terminal->index, size * sizeof(unsigned long));
+        if (storage == NULL)
+            return 0;
+        terminal->index_allocated = 1;
+    } else {
+        if (terminal->index_allocated && storage != terminal->index) {
+            free(terminal->index);
+            terminal->index_allocated = 0;
+        }
+        for (other = terminal_list; other; other = other->next) {
+            if (other != terminal && other->index == storage) {
+                other->index = NULL;
+                other->index_length = 0;
+                other->index_used = 0;
+                other->row_length = 0;
+            }
+        }
+    }
+    terminal->index = storage;
+    terminal->index_length = size;
+    terminal->row_length = row_length;
+    terminal_index_rebuild(terminal);
+    return 1;
+}
+
+static unsigned int terminal_visible_start(Terminal* terminal, 
+        unsigned int row_length, unsigned int rows) {
+    unsigned int lines, i, current_line, skip;
+    
+    if (row_length == terminal->row_length) {
+        lines = terminal_lines(terminal, row_length);
+        if (lines <= rows)
+            return 0;
+        skip = lines - rows;                   // line starts to skip
+        i = lines - 1 - terminal->index_used;  // line starts not indexed
+        if (skip > i)
+            return terminal_index_at(terminal, skip - i - 1) - terminal->base;
+    } else {
+        lines = terminal_lines(terminal, row_length);
+        if (lines <= rows)
+            return 0;
+        skip = lines - rows;
+    }
+    
+    current_line = 0;
+    for (i = 0; skip; i++) {
+        if (terminal_char_at(terminal, i) == '\n' || 
+                current_line == row_length - 1) {
+            current_line = 0;
+            skip--;
+        } else {
+            current_line++;
+        }
+    }
+    return i;
+}
+
+static unsigned int terminal_reserve(Terminal* terminal, unsigned int n,
+        char** span) {
+    unsigned int end;
+    if (!n)
+        return 0;
+    if (terminal->used + n > terminal->length) {
+        if (terminal->overflow == terminal_overflow_grow)
+            n = terminal_room(terminal, n);
+        else if (terminal->overflow == terminal_overflow_reject)
+            return 0;
+        else if (terminal->used == terminal->length) {
+            terminal_room(terminal, n);
+            if (n > terminal->length - terminal->used)
+                n = terminal->length - terminal->used;
+        }
+        if (!n)
+            return 0;
+    }
+    
+    end = terminal->start + terminal->used;
+    *span = terminal->content + (end >= terminal->length ? 
+            end - terminal->length : end);
+    if (end >= terminal->length)        // the free part is before start
+        end = terminal->start - (end - terminal->length);
+    else                                // the free part runs to the end
+        end = terminal->length - end;
+    return n < end ? n : end;
+}
+
+static void terminal_commit(Terminal* terminal, unsigned int n) {
+    unsigned int end = terminal->start + terminal->used;
+    if (!n)
+        return;
+    if (end >= terminal->length)
+        end -= terminal->length;
+    terminal_mark(terminal, terminal->base + terminal->used);
+    terminal->change.appended += n;
+    terminal_index_append(terminal, terminal->content + end, n);
+    if (terminal->attributes)
+        memset(terminal->attributes + end, terminal->attribute, n);
+    terminal->used += n;
+    if (!terminal->ring)
+        terminal->content[terminal->used] = '\0';
+    terminal_changed(terminal);
+}
+
+/**
+ * Writes characters to the end of a Terminal, through reserve and commit
+ */
+typedef struct {
+    Terminal* terminal;               // NULL to only count the characters
+    char* span;                       // span from reserve
+    unsigned int room;                // number of characters in the span
+    unsigned int used;                // number of characters written to it
+    unsigned int total;               // number of characters to write, or 0
+                                      // if unknown
+    unsigned int count;               // number of characters put so far
+    unsigned failed;                  // whether reserve failed
+} TerminalWriter;
+
+static void terminal_put(TerminalWriter* writer, char c) {
+    writer->count++;
+    if (!writer->terminal)
+        return;
+    if (writer->used == writer->room) {
+        terminal_commit(writer->terminal, writer->used);
+        writer->used = 0;
+        // Reserving on a full circular Terminal drops as much as is asked
+        // for, so without a total only room for one more is asked for then
+        writer->room = terminal_reserve(writer->terminal, writer->total ? 
+                writer->total - writer->count + 1 : 
+                writer->terminal->used < writer->terminal->length ? 16 : 1,
+                &writer->span);
+        if (!writer->room) {
+            writer->failed = 1;
+            return;
+        }
+    }
+    writer->span[writer->used++] = c;
+}
+
+static void terminal_pad(TerminalWriter* writer, char c, unsigned int n) {
+    for (; n; n--)
+        terminal_put(writer, c);
+}
+
+/**
+ * Write a number, most significant digit first
+ * @param fraction the number of decimals: value is divided by 10^fraction
+ */
+static void terminal_put_number(TerminalWriter* writer, unsigned long value,
+        unsigned negative, unsigned char base, unsigned upper,
+        unsigned char fraction, unsigned int width, unsigned char flags) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned long scale = 1, power = 1, integer;
+    unsigned int length = 1, i;
+    
+    for (i = 0; i < fraction; i++)
+        scale *= 10;
+    integer = value / scale;
+    for (; integer / power >= base; power *= base)
+        length++;
+    length += (fraction ? fraction + 1 : 0) + (negative ? 1 : 0);
+    
+    if (!(flags & terminal_left) && !(flags & terminal_zero) && width > length)
+        terminal_pad(writer, ' ', width - length);
+    if (negative)
+        terminal_put(writer, '-');
+    if (!(flags & terminal_left) && (flags & terminal_zero) && width > length)
+        terminal_pad(writer, '0', width - length);
+    for (; power; power /= base)
+        terminal_put(writer, digits[integer / power % base]);
+    if (fraction) {
+        terminal_put(writer, '.');
+        for (value %= scale, scale /= 10; scale; scale /= 10)
+            terminal_put(writer, digits[value / scale % 10]);
+    }
+    if ((flags & terminal_left) && width > length)
+        terminal_pad(writer, ' ', width - length);
+}
+
+/**
+ * Put formatted data to a writer
+ * @see terminal_format
+ */
+static void terminal_put_format(TerminalWriter* writer, const char* format,
+        va_list args) {
+    unsigned char flags, is_long;
+    unsigned int width, length;
+    int precision;
+    long value;
+    unsigned long u;
+    const char* s;
+    
+    for (; *format; format++) {
+        if (*format != '%') {
+            terminal_put(writer, *format);
+            continue;
+        }
+        
+        flags = is_long = 0;
+        width = 0;
+        precision = -1;
+        for (format++; *format == '-' || *format == '0'; format++)
+            flags |= *format == '-' ? terminal_left : terminal_zero;
+        for (; *format >= '0' && *format <= '9'; format++)
+            width = width * 10 + (*format - '0');
+        if (*format == '.')
+            for (precision = 0, format++; *format >= '0' && *format <= '9';
+                    format++)
+                precision = precision * 10 + (*format - '0');
+        if (*format == 'l') {
+            is_long = 1;
+            format++;
+        }
+        
+        switch (*format) {
+            case 'd':
+            case 'i':
+            case 'q':
+                value = is_long ? va_arg(args, long) : va_arg(args, int);
+                terminal_put_number(writer, value < 0 ? 
+                        0UL - (unsigned long) value : (unsigned long) value,
+                        value < 0, 10, 0, *format == 'q' && precision > 0 ?
+                        (precision > 9 ? 9 : precision) : 0, width, flags);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+                u = is_long ? va_arg(args, unsigned long) : 
+                        va_arg(args, unsigned int);
+                terminal_put_number(writer, u, 0, *format == 'u' ? 10 : 16,
+                        *format == 'X', 0, width, flags);
+                break;
+            case 'c':
+                if (!(flags & terminal_left) && width > 1)
+                    terminal_pad(writer, ' ', width - 1);
+                terminal_put(writer, (char) va_arg(args, int));
+                if ((flags & terminal_left) && width > 1)
+                    terminal_pad(writer, ' ', width - 1);
+                break;
+            case 's':
+                s = va_arg(args, const char*);
+                for (length = 0; s[length] && 
+                        (precision < 0 || length < (unsigned int) precision);
+                        length++);
+                if (!(flags & terminal_left) && width > length)
+                    terminal_pad(writer, ' ', width - length);
+                for (u = 0; u < length; u++)
+                    terminal_put(writer, s[u]);
+                if ((flags & terminal_left) && width > length)
+                    terminal_pad(writer, ' ', width - length);
+                break;
+            case '\0':
+                format--;               // a % at the end is left out
+                break;
+            default:                    // %% and unknown conversions
+                terminal_put(writer, *format);
+        }
+    }
+}
+
+static unsigned terminal_format(Terminal* terminal, const char* format, ...) {
+    TerminalWriter writer = {terminal, NULL, 0, 0, 0, 0, 0};
+    TerminalWriter counter = {NULL, NULL, 0, 0, 0, 0, 0};
+    va_list args, measure;
+    
+    va_start(args, format);
+    // Rejecting is all or nothing, so the length is measured first
+    if (terminal->overflow == terminal_overflow_reject) {
+        va_copy(measure, args);
+        terminal_put_format(&counter, format, measure);
+        va_end(measure);
+        if (terminal->used + counter.count > terminal->length) {
+            va_end(args);
+            return 0;
+        }
+        writer.total = counter.count;
+    }
+    terminal_begin(terminal);
+    terminal_put_format(&writer, format, args);
+    va_end(args);
+    terminal_commit(terminal, writer.used);
+    terminal_end(terminal);
+    return !writer.failed;
+}
+
+static unsigned terminal_use_attributes(Terminal* terminal) {
+    if (terminal->attributes)
+        return 1;
+    if (terminal->fixed)
+        return 0;
+    terminal->attributes = calloc(1, terminal->length + 1);
+    terminal->attributes_allocated = 1;
+    return terminal->attributes != NULL;
+}
+
+static void terminal_set_attribute(Terminal* terminal, unsigned char attribute) {
+    terminal->attribute = attribute;
+}
+
+static void terminal_change_attributes(Terminal* terminal, unsigned int from,
+        unsigned int n, unsigned char attribute) {
+    unsigned int i;
+    if (!terminal->attributes || from >= terminal->used)
+        return;
+    if (n > terminal->used - from)
+        n = terminal->used - from;
+    for (i = from + terminal->start; n; i++, n--) {
+        if (i >= terminal->length)
+            i -= terminal->length;
+        terminal->attributes[i] = attribute;
+    }
+    terminal_mark(terminal, terminal->base + from);
+    terminal_changed(terminal);
+}
+
+static unsigned char terminal_attribute_at(Terminal* terminal, unsigned int i) {
+    if (!terminal->attributes)
+        return 0;
+    i += terminal->start;
+    if (i >= terminal->length)
+        i -= terminal->length;
+    return terminal->attributes[i];
+}
+
 const Terminal_namespace terminal = {
     terminal_construct,
     terminal_free,
@@ -115,5 +880,25 @@ const Terminal_namespace terminal = {
     terminal_appendChar,
     terminal_discard,
     terminal_lines_needed,
-    terminal_discard_first_line
+    terminal_discard_first_line,
+    terminal_construct_ring,
+    terminal_init,
+    terminal_take,
+    terminal_size,
+    terminal_char_at,
+    terminal_drop,
+    terminal_lines,
+    terminal_drop_first_line,
+    terminal_index_lines,
+    terminal_visible_start,
+    terminal_begin,
+    terminal_end,
+    terminal_flush,
+    terminal_use_attributes,
+    terminal_set_attribute,
+    terminal_change_attributes,
+    terminal_attribute_at,
+    terminal_reserve,
+    terminal_commit,
+    terminal_format
 };
@@ -26,6 +26,27 @@
  * rect updates on a display or elsewhere. 
  * Data may be added and removed at the end of the string, nowhere else.
  * 
+ * A Terminal constructed with construct_ring has a fixed capacity. Its content
+ * is a circular buffer: when it is full, appending drops the oldest characters.
+ * In this mode content is not a null-terminated string; use size and char_at
+ * to read it.
+ * 
+ * Without a heap, a Terminal can be placed in static storage with init, or
+ * taken from a pool of terminal_pool_size Terminals with take. These do not
+ * grow; the overflow policy says what appending to a full Terminal does.
+ * 
+ * A Terminal may keep an index of where its lines start for one row length,
+ * see index_lines. The index is updated on every change, so that lines and
+ * visible_start do not need to scan the data.
+ * 
+ * With use_attributes, every character also has an attribute, such as one of
+ * the t6963c_attr_* values. Appended characters get the attribute set with
+ * set_attribute; change_attributes changes the attributes of existing ones.
+ * 
+ * Changes may be batched with begin and end. The update callback is then
+ * called once at the end of the batch, and Terminal.change describes all
+ * changes in the batch.
+ * 
  * The namespace_struct eases function names. Functions may now be called any-
  * where with, for example:
  * 
@@ -39,10 +60,61 @@
 extern "C" {
 #endif
 
+#ifndef terminal_pool_size
+#define terminal_pool_size 0            // Number of Terminals for take
+#endif
+#ifndef terminal_pool_length
+#define terminal_pool_length 256        // Capacity of every Terminal for take
+#endif
+#ifndef terminal_pool_attributes
+#define terminal_pool_attributes 0      // Whether Terminals for take have
+                                        // attributes
+#endif
+
+// What appending does when a Terminal is full
+#define terminal_overflow_grow 0        // allocate a larger block
+#define terminal_overflow_drop 1        // drop the oldest characters
+#define terminal_overflow_reject 2      // append nothing, and return 0
+#define terminal_overflow_truncate 3    // append what fits, and return 0
+
+/**
+ * A description of the changes to a Terminal since its last update. Positions
+ * count all characters ever stored in the Terminal, like Terminal.base.
+ */
+typedef struct {
+    unsigned changed;                 // whether anything changed
+    unsigned long from;               // first position that changed
+    unsigned int appended;            // number of characters appended
+    unsigned int discarded;           // characters discarded from the end
+    unsigned long dropped;            // characters dropped from the start
+} TerminalChange;
+
 typedef struct Terminal {
     char* content;                    // actual content
+    unsigned char* attributes;        // attribute per character, or NULL
+    unsigned char attribute;          // attribute of appended characters
     unsigned int length;              // length of the allocated memory block
     void (*update)(struct Terminal*); // update callback
+    void* data;                       // for the update callback
+    unsigned int start;               // index of the first character
+    unsigned int used;                // number of characters in use
+    unsigned ring;                    // whether content is a circular buffer
+    unsigned char overflow;           // terminal_overflow_*
+    unsigned fixed;                   // whether the Terminal and content are
+                                      // not allocated here
+    unsigned attributes_allocated;    // whether attributes was allocated here
+    unsigned long base;               // number of characters dropped so far
+    unsigned long* index;             // positions where lines start
+    unsigned index_allocated;         // whether index was allocated here
+    unsigned int index_length;        // number of slots in index
+    unsigned int index_first;         // slot of the oldest line start
+    unsigned int index_used;          // number of line starts in index
+    unsigned int row_length;          // row length of the index, 0 if none
+    unsigned int line_count;          // number of lines, 0 if unknown
+    unsigned int column;              // column of the end of the data
+    unsigned int batches;             // number of unfinished batches
+    TerminalChange change;            // changes since the last update
+    struct Terminal* next;            // next in the list of all Terminals
 } Terminal;
 
 typedef struct {
@@ -52,28 +124,32 @@ typedef struct {
     Terminal* (*const construct)(unsigned int size);
     
     /**
-     * Free a Terminal and all blocks allocated for it
+     * Free a Terminal and all blocks allocated for it. A Terminal from take
+     * is returned to the pool.
      */
     void (*const free)(Terminal*);
     
     /**
      * Append a string to a Terminal's data, and call the update callback
      * A larger block of memory is allocated if needed.
-     * @return 0 if allocating more memory failed, 1 otherwise
+     * @return 0 if allocating more memory failed or not everything fit, 1
+     *   otherwise
      */
     unsigned (*const append)(Terminal*, char*);
 
     /**
 	 * Append a part of a string to a Terminal's data, and call the update
 	 * callback A larger block of memory is allocated if needed.
-     * @return 0 if allocating more memory failed, 1 otherwise
+     * @return 0 if allocating more memory failed or not everything fit, 1
+     *   otherwise
      */
     unsigned (*const append_n)(Terminal*, char*, unsigned short);
     
     /**
      * Append a character to a Terminal's data, and call the update callback
      * A larger block of memory is allocated if needed.
-     * @return 0 if allocating more memory failed, 1 otherwise
+     * @return 0 if allocating more memory failed or not everything fit, 1
+     *   otherwise
      */
     unsigned (*const appendChar)(Terminal*, char);
     
@@ -86,16 +162,167 @@ typedef struct {
     /**
      * Calculate how many lines are needed to display a string on a display with
      * n columns, if words wrap occur at any place in a word and \n gives a new
-     * line.
+     * line. When the string is the content of a Terminal, this is lines.
      */
     unsigned int (*const lines_needed)(char*, unsigned int row_length);
     
     /**
      * Discard the first line of a string, where a line has n columns - that is,
      * discard until the first \n or until n characters have passed, whichever
-     * occurs first.
+     * occurs first. When the string is the content of a Terminal, this is
+     * drop_first_line, which keeps the Terminal consistent.
      */
     void (*const discard_first_line)(char*, unsigned int row_length);
+    
+    /**
+     * Construct a new Terminal with a fixed capacity, storing its content in a
+     * circular buffer. Appending to a full Terminal drops the oldest data.
+     */
+    Terminal* (*const construct_ring)(unsigned int size);
+    
+    /**
+     * Set up a Terminal in storage of the caller, without using the heap.
+     * With terminal_overflow_drop, content is a circular buffer; with
+     * terminal_overflow_grow, the Terminal rejects what does not fit.
+     * @param content storage for size + 1 characters
+     * @param attributes storage for size + 1 attributes, or NULL
+     * @param overflow a terminal_overflow_* value
+     */
+    Terminal* (*const init)(Terminal*, char* content, 
+            unsigned char* attributes, unsigned int size,
+            unsigned char overflow);
+    
+    /**
+     * Take a Terminal of terminal_pool_length characters from a static pool,
+     * like init. free returns it to the pool.
+     * @param overflow a terminal_overflow_* value
+     * @return NULL if all Terminals in the pool are taken
+     */
+    Terminal* (*const take)(unsigned char overflow);
+    
+    /**
+     * The number of characters in a Terminal
+     */
+    unsigned int (*const size)(Terminal*);
+    
+    /**
+     * The character at a position, counted from the first character
+     */
+    char (*const char_at)(Terminal*, unsigned int);
+    
+    /**
+     * Discard the first n characters of a Terminal's data. The update callback
+     * is not called.
+     */
+    void (*const drop)(Terminal*, unsigned int);
+    
+    /**
+     * Like lines_needed, but for the data of a Terminal.
+     */
+    unsigned int (*const lines)(Terminal*, unsigned int row_length);
+    
+    /**
+     * Like discard_first_line, but for the data of a Terminal. The update
+     * callback is not called.
+     */
+    void (*const drop_first_line)(Terminal*, unsigned int row_length);
+    
+    /**
+     * Keep an index of the line starts of a Terminal's data for a row length.
+     * After this, lines, drop_first_line and visible_start take constant time
+     * for that row length. The index holds the starts of the last size lines;
+     * older lines are still counted. If storage is NULL, it is allocated,
+     * except for a Terminal from init or take. Another Terminal that kept its
+     * index in storage loses it. A circular Terminal with an index drops whole
+     * lines when it is full.
+     * @return 0 if allocating the index failed, 1 otherwise
+     */
+    unsigned (*const index_lines)(Terminal*, unsigned int row_length,
+            unsigned long* storage, unsigned int size);
+    
+    /**
+     * The position of the first character that is visible when the last rows
+     * lines of a Terminal's data are displayed.
+     */
+    unsigned int (*const visible_start)(Terminal*, unsigned int row_length,
+            unsigned int rows);
+    
+    /**
+     * Begin a batch of changes. Until the matching end, the update callback is
+     * not called. Batches may be nested.
+     */
+    void (*const begin)(Terminal*);
+    
+    /**
+     * End a batch of changes. When this is the outermost batch and something
+     * changed, the update callback is called.
+     */
+    void (*const end)(Terminal*);
+    
+    /**
+     * Call the update callback if something changed, also inside a batch.
+     */
+    void (*const flush)(Terminal*);
+    
+    /**
+     * Keep an attribute for every character. The characters that are already
+     * in the Terminal get attribute 0. A Terminal from init or take only has
+     * attributes in the storage given to init, or with terminal_pool_attributes.
+     * @return 0 if allocating memory failed or the Terminal has no storage for
+     *   attributes, 1 otherwise
+     */
+    unsigned (*const use_attributes)(Terminal*);
+    
+    /**
+     * Set the attribute of the characters that are appended from now on
+     */
+    void (*const set_attribute)(Terminal*, unsigned char attribute);
+    
+    /**
+     * Change the attribute of n characters from a position on, counted from
+     * the first character, and call the update callback.
+     */
+    void (*const change_attributes)(Terminal*, unsigned int from,
+            unsigned int n, unsigned char attribute);
+    
+    /**
+     * The attribute of the character at a position, counted from the first
+     * character. This is 0 if the Terminal has no attributes.
+     */
+    unsigned char (*const attribute_at)(Terminal*, unsigned int);
+    
+    /**
+     * Get room to write up to n characters at the end of a Terminal's data,
+     * without copying. Write to the span, then append what was written with
+     * commit. A circular Terminal only drops the oldest data when it is full,
+     * and then drops enough for n characters; until then it may give less
+     * room than n. Reserve again for the rest. With
+     * terminal_overflow_reject, there is room for all n characters or none.
+     * @param span is set to the room
+     * @return the number of characters that fit in the span, or 0 if
+     *   allocating memory failed or the Terminal is full
+     */
+    unsigned int (*const reserve)(Terminal*, unsigned int n, char** span);
+    
+    /**
+     * Append the first n characters that were written to the span of the
+     * last reserve, and call the update callback.
+     */
+    void (*const commit)(Terminal*, unsigned int n);
+    
+    /**
+     * Append formatted data, like printf, and call the update callback once.
+     * The output is written directly into the Terminal, through reserve and
+     * commit, without buffers or heap use of its own.
+     * Conversions: %d, %i, %u, %x, %X, %c, %s and %%, with the flags - and 0,
+     * a width, a precision for %s and l for longs. %.Nq writes an int as a
+     * fixed-point number with N decimals: %.2q of 2150 gives 21.50.
+     * With terminal_overflow_reject, nothing is appended unless everything
+     * fits.
+     * @return 0 if allocating more memory failed or not everything fit, 1
+     *   otherwise
+     */
+    unsigned (*const format)(Terminal*, const char* format, ...);
 } Terminal_namespace;
 
 extern const Terminal_namespace terminal;
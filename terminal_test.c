@@ -0,0 +1,269 @@
+/**
+ * C library for interfacing a T6963C display with a PIC microcontroller
+ * Copyright (C) 2015 Camil Staps <info@camilstaps.nl>
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ *******************************************************************************
+ *
+ * File:   terminal_test.c
+ * Author: Camil Staps <info@camilstaps.nl>
+ *
+ * Tests for the Terminal library, on a host. Every failed check is printed;
+ * the exit status is the number of failures, capped at 255.
+ *
+ * Usage: terminal_test
+ */
+
+#include "terminal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int test_failures;
+
+#define test_check(condition) test_report(condition, #condition, __LINE__)
+
+static void test_report(unsigned ok, const char* condition, unsigned line) {
+    if (ok)
+        return;
+    printf("terminal_test.c:%u: failed: %s\n", line, condition);
+    test_failures++;
+}
+
+/**
+ * The updates a Terminal called back, with the change and the end of the data
+ * at the time
+ */
+static unsigned int test_updates;
+static TerminalChange test_change;
+static unsigned long test_end;
+
+static void test_update(Terminal* term) {
+    test_updates++;
+    test_change = term->change;
+    test_end = term->base + terminal.size(term);
+}
+
+/**
+ * A batch calls the update callback once, at the outermost end, with all its
+ * changes
+ */
+static void test_batch(void) {
+    Terminal* term = terminal.construct_ring(16);
+    terminal.append(term, "hello world");
+    term->update = test_update;
+    test_updates = 0;
+    terminal.begin(term);
+    terminal.append(term, "abc");
+    terminal.discard(term, 2);
+    terminal.begin(term);
+    terminal.appendChar(term, 'x');
+    terminal.end(term);
+    test_check(!test_updates);
+    terminal.format(term, "%d", 12345);
+    terminal.end(term);
+    test_check(test_updates == 1);
+    test_check(test_change.changed && test_change.from == 11);
+    test_check(test_change.appended == 9 && test_change.discarded == 2);
+    test_check(test_change.dropped == 2 && test_end == 18);
+    test_check(!term->change.changed);
+    terminal.end(term);
+    test_check(test_updates == 1);
+    terminal.free(term);
+}
+
+/**
+ * Dropping to the middle of a line moves the wrap positions of the rows after
+ * it
+ */
+static void test_drop_mid_line(void) {
+    Terminal* term = terminal.construct_ring(10);
+    terminal.index_lines(term, 4, NULL, 8);
+    terminal.append(term, "abcdefgh");
+    terminal.drop(term, 2);
+    test_check(terminal.visible_start(term, 4, 1) == 4);
+    test_check(terminal.lines(term, 4) == 2);
+    terminal.free(term);
+}
+
+/**
+ * Dropping the first line keeps the index when that line is older than the
+ * line starts in it, instead of rebuilding it
+ */
+static void test_drop_unindexed_line(void) {
+    Terminal* term = terminal.construct(64);
+    unsigned int first;
+    terminal.index_lines(term, 4, NULL, 3);
+    terminal.append(term, "a\nb\nc\nd\ne\n");
+    first = term->index_first;
+    terminal.drop_first_line(term, 4);
+    test_check(term->index_first == first && term->index_used == 3);
+    test_check(terminal.lines(term, 4) == 5);
+    test_check(terminal.visible_start(term, 4, 3) == 4);
+    terminal.free(term);
+}
+
+/**
+ * A Terminal with an index must give the same lines and visible starts as a
+ * copy of its data without index, which is scanned, also when it is a ring
+ * that drops characters when full
+ */
+static void test_index_matches_scan(void) {
+    Terminal* indexed = terminal.construct_ring(64);
+    Terminal* scanned;
+    char text[65];
+    unsigned int i, j, n, rows, failures = test_failures;
+    terminal.index_lines(indexed, 7, NULL, 16);
+    srand(1);
+    for (i = 0; i < 5000 && test_failures == failures; i++) {
+        n = rand() % 20;
+        for (j = 0; j < n; j++)
+            text[j] = rand() % 6 ? 'a' + rand() % 26 : '\n';
+        text[n] = '\0';
+        switch (rand() % 5) {
+            case 0:
+                terminal.drop(indexed, rand() % 8);
+                break;
+            case 1:
+                terminal.drop_first_line(indexed, 7);
+                break;
+            default:
+                terminal.append(indexed, text);
+        }
+
+        n = terminal.size(indexed);
+        for (j = 0; j < n; j++)
+            text[j] = terminal.char_at(indexed, j);
+        text[n] = '\0';
+        scanned = terminal.construct(64);
+        terminal.append(scanned, text);
+        test_check(terminal.lines(indexed, 7) == terminal.lines(scanned, 7));
+        for (rows = 1; rows < 12; rows++)
+            test_check(terminal.visible_start(indexed, 7, rows) ==
+                    terminal.visible_start(scanned, 7, rows));
+        terminal.free(scanned);
+    }
+    terminal.free(indexed);
+}
+
+/**
+ * With terminal_overflow_reject, reserve and format append all or nothing
+ */
+static void test_reject(void) {
+    Terminal term;
+    char content[11], *span;
+    terminal.init(&term, content, NULL, 10, terminal_overflow_reject);
+    terminal.append(&term, "12345678");
+    test_check(!terminal.format(&term, "%s", "abcdef"));
+    test_check(!strcmp(term.content, "12345678"));
+    test_check(!terminal.reserve(&term, 3, &span));
+    test_check(terminal.format(&term, "%d", 42));
+    test_check(!strcmp(term.content, "1234567842"));
+    terminal.free(&term);
+}
+
+/**
+ * Reserving on a full circular Terminal drops enough for all n characters
+ */
+static void test_reserve_full(void) {
+    Terminal* term = terminal.construct_ring(8);
+    char data[9], *span;
+    unsigned int i, n;
+    terminal.append(term, "abcdefgh");
+    n = terminal.reserve(term, 4, &span);
+    test_check(n == 4);
+    memcpy(span, "wxyz", n);
+    terminal.commit(term, n);
+    for (i = 0; i < terminal.size(term); i++)
+        data[i] = terminal.char_at(term, i);
+    data[i] = '\0';
+    test_check(!strcmp(data, "efghwxyz"));
+    terminal.format(term, "%d", 12);
+    for (i = 0; i < terminal.size(term); i++)
+        data[i] = terminal.char_at(term, i);
+    data[i] = '\0';
+    test_check(!strcmp(data, "ghwxyz12"));
+    terminal.free(term);
+}
+
+/**
+ * With terminal_overflow_truncate, format appends what fits
+ */
+static void test_truncate(void) {
+    Terminal term;
+    char content[11];
+    terminal.init(&term, content, NULL, 10, terminal_overflow_truncate);
+    terminal.append(&term, "12345678");
+    test_check(!terminal.format(&term, "%s", "abcdef"));
+    test_check(!strcmp(term.content, "12345678ab"));
+    terminal.free(&term);
+}
+
+/**
+ * A Terminal from init does not allocate an index or attributes, and an index
+ * in storage of the caller moves to the last Terminal that is given it
+ */
+static void test_storage(void) {
+    Terminal term, other;
+    char content[11], other_content[11];
+    unsigned long index[4];
+    terminal.init(&term, content, NULL, 10, terminal_overflow_drop);
+    terminal.init(&other, other_content, NULL, 10, terminal_overflow_drop);
+    test_check(!terminal.index_lines(&term, 4, NULL, 4));
+    test_check(!term.index);
+    test_check(!terminal.use_attributes(&term));
+    terminal.append(&term, "ab\ncd\nef");
+    terminal.append(&other, "abcdefgh");
+    test_check(terminal.index_lines(&term, 4, index, 4));
+    test_check(terminal.lines(&term, 4) == 3);
+    test_check(terminal.index_lines(&other, 3, index, 4));
+    test_check(!term.index && !term.row_length);
+    test_check(terminal.lines(&term, 4) == 3);
+    test_check(terminal.lines(&other, 3) == 3);
+    terminal.free(&term);
+    terminal.free(&other);
+}
+
+/**
+ * The functions that take a string keep a Terminal consistent when they are
+ * given its content
+ */
+static void test_string_functions(void) {
+    Terminal* term = terminal.construct(4);
+    terminal.append(term, "hello\nworld");
+    test_check(terminal.lines_needed(term->content, 40) == 2);
+    terminal.discard_first_line(term->content, 40);
+    terminal.append(term, "x");
+    test_check(terminal.size(term) == 6);
+    test_check(!strcmp(term->content, "worldx"));
+    test_check(terminal.lines_needed(term->content, 4) == 2);
+    terminal.free(term);
+}
+
+int main(void) {
+    test_batch();
+    test_drop_mid_line();
+    test_drop_unindexed_line();
+    test_string_functions();
+    test_storage();
+    test_reserve_full();
+    test_reject();
+    test_truncate();
+    test_index_matches_scan();
+    if (test_failures)
+        printf("%u checks failed\n", test_failures);
+    return test_failures > 255 ? 255 : test_failures;
+}